@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+// Templates cycled through when generating a script. %zu is replaced by line number.
+static const char *Script_Lines[] = {
+	"# Generated deployment step %zu, do not edit by hand.\n",
+	"$host_%zu = \"web-%zu.internal.example.com\"\n",
+	"$port_%zu = 8080 + %zu * 2\n",
+	"$msg_%zu = `deploying $host_%zu on port $port_%zu`\n",
+	"print $port_%zu\n",
+	"$ok_%zu = $port_%zu >= 1024\n",
+	"print \"step %zu finished without errors, moving on to the next host\"\n",
+	"#################################################################### section %zu ####\n",
+	"$cmd_%zu = `tar -czf /var/backups/app-$host_%zu.tar.gz --exclude=node_modules --exclude=.git /srv/app && scp /var/backups/app.tar.gz backup@$host_%zu:/srv/backups/`\n",
+	"        \t    \n",
+	"\n",
+};
+
+double bench_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+char *bench_gen_script(size_t lines, size_t *len) {
+	size_t cap = lines * 96 + 256;
+	size_t n = 0;
+	size_t tmpl_ct = sizeof(Script_Lines) / sizeof(Script_Lines[0]);
+	char *buff = malloc(cap);
+
+	for (size_t i = 0; i < lines; i++) {
+		if (cap - n < 256) {
+			cap *= 2;
+			buff = realloc(buff, cap);
+		}
+
+		// Every so often emit a group with a few commands.
+		if (i % 64 == 63) {
+			n += snprintf(buff + n, cap - n, "deploy_%zu {\n\"sudo systemctl restart app\"\n\"curl -s localhost/health\"\n}\n", i);
+			i += 3;
+			continue;
+		}
+		n += snprintf(buff + n, cap - n, Script_Lines[i % tmpl_ct], i, i, i);
+	}
+
+	buff[n] = '\0';
+	*len = n;
+	return buff;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file bench.h
+ * @author Sayed Sadeed
+ * @brief Shared helpers for the benchmark programs.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+
+/**
+ * @brief Monotonic wall clock in seconds.
+ */
+double bench_now(void);
+
+/**
+ * @brief Generate a synthetic vmel script.
+ * 
+ * The script mixes comments, assignments, arithmetic, mixed strings,
+ * prints and groups in roughly the proportions seen in generated
+ * deployment scripts. Buffer is malloc'ed and null terminated.
+ * 
+ * @param lines Approximate number of lines to generate.
+ * @param len Set to the length of the generated script.
+ * @return Pointer to the script.
+ */
+char *bench_gen_script(size_t lines, size_t *len);
+
+#endif
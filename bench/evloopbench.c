@@ -0,0 +1,126 @@
+/**
+ * Sessions per second and tail latency of running a group across many simulated
+ * hosts, driven by the event loop against one thread per active host. Every host
+ * is a local sh child running a command which sleeps for a while, standing in for
+ * network latency, then prints a line. Latency is the time from connecting to a host
+ * to its command being done, output is compared to the expected line.
+ *
+ * Usage: evloopbench [hosts] [sleep]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "evloop.h"
+#include "bench.h"
+
+/**
+ * @brief Hosts shared by the threads of the baseline, next claimed atomically.
+ */
+typedef struct {
+	const char *cmd;
+	HostResult *hosts;
+	size_t host_ctr;
+	size_t next;
+} ThreadJob;
+
+// Run hosts through Transport_run() until none are left.
+static void *thread_worker(void *arg) {
+	ThreadJob *job = arg;
+	size_t idx = 0;
+
+	while ((idx = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->host_ctr) {
+		HostResult *host = &job->hosts[idx];
+		double t0 = bench_now();
+		TransportSession *session = Transport_open(Transport_local(), host->host);
+
+		if (!session || Transport_run(session, job->cmd, &host->res) == -1)
+			host->res.status = -1;
+		host->cmd_ctr = 1;
+		Transport_close(session);
+		host->secs = bench_now() - t0;
+	}
+
+	return NULL;
+}
+
+// Run hosts on active threads.
+static void run_threads(const char *cmd, HostResult *hosts, size_t host_ctr, size_t active) {
+	pthread_t *threads = malloc(active * sizeof(pthread_t));
+	ThreadJob job = { cmd, hosts, host_ctr, 0 };
+	size_t thread_ctr = 0;
+
+	for (size_t i = 0; i < active; i++)
+		if (pthread_create(&threads[thread_ctr], NULL, thread_worker, &job) == 0)
+			thread_ctr++;
+
+	for (size_t i = 0; i < thread_ctr; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+}
+
+// Order latencies for percentiles.
+static int compare_secs(const void *a, const void *b) {
+	double x = *(const double *) a;
+	double y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+// Print sessions per second and latency percentiles of a run, return the number of bad results.
+static size_t report(const char *name, size_t active, HostResult *hosts, size_t host_ctr, double elapsed) {
+	double *secs = malloc(host_ctr * sizeof(double));
+	VString out = VString_new();
+	size_t bad = 0;
+
+	for (size_t i = 0; i < host_ctr; i++) {
+		secs[i] = hosts[i].secs;
+		bad += hosts[i].res.status != 0 || strcmp(VRope_flatten(&hosts[i].res.out, &out), "ok\n") != 0;
+	}
+
+	qsort(secs, host_ctr, sizeof(double), compare_secs);
+	printf("%-8s %7zu %12.0f %10.1f %10.1f %10.1f%s\n", name, active, host_ctr / elapsed,
+		secs[host_ctr / 2] * 1e3, secs[host_ctr * 99 / 100] * 1e3, secs[host_ctr - 1] * 1e3,
+		bad ? "  (bad result)" : "");
+
+	VString_free(&out);
+	free(secs);
+	return bad;
+}
+
+int main(int argc, char *argv[]) {
+	size_t host_ctr = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000;
+	const char *sleep = argc > 2 ? argv[2] : "0.05";
+	size_t actives[] = { 16, 64, 256 };
+	char cmd[64];
+	int failed = 0;
+
+	if (!host_ctr)
+		host_ctr = 1;
+	snprintf(cmd, sizeof(cmd), "sleep %s; echo ok", sleep);
+
+	HostResult *hosts = calloc(host_ctr, sizeof(HostResult));
+	char *cmds[] = { cmd };
+
+	printf("%-8s %7s %12s %10s %10s %10s\n", "driver", "active", "sessions/s", "p50 ms", "p99 ms", "max ms");
+	for (size_t a = 0; a < sizeof(actives) / sizeof(actives[0]); a++) {
+		for (int use_loop = 0; use_loop < 2; use_loop++) {
+			for (size_t i = 0; i < host_ctr; i++)
+				hosts[i] = (HostResult) { TRANSPORT_LOCALHOST, TransportResult_new(), 0, 0 };
+
+			double t0 = bench_now();
+			if (use_loop)
+				failed |= EvLoop_run(Transport_local(), cmds, 1, hosts, host_ctr, actives[a], 0) == -1;
+			else
+				run_threads(cmd, hosts, host_ctr, actives[a]);
+			double elapsed = bench_now() - t0;
+
+			failed |= report(use_loop ? "evloop" : "threads", actives[a], hosts, host_ctr, elapsed) != 0;
+			for (size_t i = 0; i < host_ctr; i++)
+				TransportResult_free(&hosts[i].res);
+		}
+	}
+
+	free(hosts);
+	return failed;
+}
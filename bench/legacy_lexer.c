@@ -0,0 +1,244 @@
+/**
+ * Frozen copy of the if/else chain tokenizer which predates the table driven
+ * lexer. Only kept so lexbench can compare the two on identical input.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "utils.h"
+#include "tokenizer.h"
+#include "tokens.h"
+
+// Identifier check as it was implemented in utils.c.
+static int legacy_is_identifier(char id) {
+	return (isalpha(id) || id == '_' || id == '-' || isdigit(id));
+}
+
+// Ensure a variable confirms to naming specifications.
+static int is_legal_variable(char c) {
+	return c != MINUS && !isdigit(c);
+}
+
+int legacy_build_tokens(const char *buff, TokenMgr *tokmgr) {
+	if (null_check((void *) buff, "Tokenizer build tokens") || null_check(tokmgr, "Tokenizer build tokens"))
+		return -1;
+
+	// Each character in buffer.
+	char c;
+	// Start of the lexeme currently being read.
+	size_t start = 0;
+	// Buff iterator.
+	size_t bidx = 0;
+	// Error code.
+	int error = 0;
+	// Track line no.
+	int lineno = 1;
+	int brlock = 0;
+
+	tokmgr->src = buff;
+
+	while (buff[bidx] != '\0' && !error) {
+		c = buff[bidx];
+		start = bidx;
+
+		// Spaces and irrelevant characters.
+		if (c == COMMENT) {
+			while (c != NEWLINE && c != '\0') {
+				c = buff[++bidx];
+			}
+			continue;
+		}
+		else if (isspace(c) && c != NEWLINE) {
+			while (isspace(c) && c != NEWLINE) {
+				c = buff[++bidx];
+			}
+			continue;
+		}
+		else if (c == NEWLINE) {
+			lineno++;
+			bidx++;
+			continue;
+		}
+		// Simple literals.
+		else if (c == LBRACKET) {
+			TokenMgr_add_token(tokmgr, E_LBRACKET_TOKEN, start, 1, lineno);
+			bidx++;
+		}
+		else if (c == LBRACE) {
+			TokenMgr_add_token(tokmgr, E_LBRACE_TOKEN, start, 1, lineno);
+			brlock = 1;
+			bidx++;
+		}
+		else if (c == RBRACE) {
+			brlock = 0;
+			TokenMgr_add_token(tokmgr, E_RBRACE_TOKEN, start, 1, lineno);
+			bidx++;
+		}
+		else if (c == RBRACKET) {
+			TokenMgr_add_token(tokmgr, E_RBRACKET_TOKEN, start, 1, lineno);
+			bidx++;
+		}
+		else if (c == LPAREN) {
+			TokenMgr_add_token(tokmgr, E_LPAREN_TOKEN, start, 1, lineno);
+			bidx++;
+		}
+		else if (c == RPAREN) {
+			TokenMgr_add_token(tokmgr, E_RPAREN_TOKEN, start, 1, lineno);
+			bidx++;
+		}
+		else if (c == PLUS) {
+			TokenMgr_add_token(tokmgr, E_PLUS_TOKEN, start, 1, lineno);
+			bidx++;
+		} 
+		else if (c ==  MINUS) {
+			TokenMgr_add_token(tokmgr, E_MINUS_TOKEN, start, 1, lineno);
+			bidx++;
+		} 
+		else if (c ==  ASTERISK) {
+			TokenMgr_add_token(tokmgr, E_ASTERISK_TOKEN, start, 1, lineno);
+			bidx++;
+		} 
+		else if (c == FSLASH) {
+			TokenMgr_add_token(tokmgr, E_FSLASH_TOKEN, start, 1, lineno);
+			bidx++;
+		}
+		else if (c == COMMA) {
+			TokenMgr_add_token(tokmgr, E_COMMA_TOKEN, start, 1, lineno);
+			bidx++;
+		}
+		// Compound literals.
+		else if (c == BTICK) {
+			c = buff[++bidx];
+			start = bidx;
+			while (c != BTICK && c != '\0' && c != NEWLINE) {
+				c = buff[++bidx];
+			}
+			if (c != BTICK) {
+				error = 1;
+				continue;
+			}
+			TokenMgr_add_token(tokmgr, E_MIXSTR_TOKEN, start, bidx - start, lineno);
+			bidx++;
+		}
+		else if (c == BANG) {
+			if (buff[bidx+1] == EQUAL) {
+				TokenMgr_add_token(tokmgr, E_NEQUAL_TOKEN, start, 2, lineno);
+				bidx++;
+			}
+			else {
+				TokenMgr_add_token(tokmgr, E_NOT_TOKEN, start, 1, lineno);
+			}
+			bidx++;
+		}
+		else if (c == LESSTHAN) {
+			if (buff[bidx+1] == EQUAL) {
+				TokenMgr_add_token(tokmgr, E_LESSTHANEQ_TOKEN, start, 2, lineno);
+				bidx++;
+			}
+			else {
+				TokenMgr_add_token(tokmgr, E_LESSTHAN_TOKEN, start, 1, lineno);
+			}
+			bidx++;
+		}
+		else if (c == GREATERTHAN) {
+			switch(buff[++bidx]) {
+				case EQUAL:
+					TokenMgr_add_token(tokmgr, E_GREATERTHANEQ_TOKEN, start, 2, lineno);
+					break;
+				case LESSTHAN:
+					TokenMgr_add_token(tokmgr, E_BETWEEN_TOKEN, start, 2, lineno);
+					break;
+				default:
+					bidx--;
+					TokenMgr_add_token(tokmgr, E_GREATERTHAN_TOKEN, start, 1, lineno);
+					break;
+			}
+			bidx++;
+		}
+		else if (c ==  EQUAL) {
+			if (buff[bidx+1] == EQUAL) {
+				TokenMgr_add_token(tokmgr, E_EEQUAL_TOKEN, start, 2, lineno);
+				bidx++;
+			}
+			else {
+				TokenMgr_add_token(tokmgr, E_EQUAL_TOKEN, start, 1, lineno);
+			}	
+			bidx++;
+		}
+		
+		else if (c == DQUOTE) {
+			c = buff[++bidx];
+			start = bidx;
+			while (c != DQUOTE && c != '\0' && c != NEWLINE) {
+				c = buff[++bidx];
+			}
+			// Ensure last read char is closing quote.
+			if (c != DQUOTE) {
+				error = 1;
+				continue;
+			}
+			TokenMgr_add_token(tokmgr, E_STRING_TOKEN, start, bidx - start, lineno);
+			bidx++;
+		}
+		else if (c == VAR) {
+			c = buff[++bidx];
+			start = bidx;
+
+			while (legacy_is_identifier(c)) {
+				c = buff[++bidx];
+			}
+
+			// Prevent empty variables e.g $
+			if (bidx == start || !is_legal_variable(buff[start])) {
+				error = 1;
+				continue;
+			}
+
+			TokenMgr_add_token(tokmgr, E_IDENTIFIER_TOKEN, start, bidx - start, lineno);
+		}
+		else if (isdigit(c)) {
+			while (isdigit(c)) {
+				c = buff[++bidx];
+			}
+			// A word can't directly follow a number e.g 12abc, both would share a terminator.
+			if (isalpha(c)) {
+				error = 1;
+				continue;
+			}
+			TokenMgr_add_token(tokmgr, E_INTEGER_TOKEN, start, bidx - start, lineno);
+		}
+		else if (isalpha(c)) {
+			if (brlock) {
+				while (c != LBRACE && c != RBRACE && c != NEWLINE && c != '\0') {
+					c = buff[++bidx];	
+				}
+			}
+			else {
+				while (legacy_is_identifier(c)) {
+					c = buff[++bidx];
+				}
+			}
+			if (brlock)
+				TokenMgr_add_token(tokmgr, E_STRING_TOKEN, start, bidx - start, lineno);
+			else
+				TokenMgr_add_token(tokmgr, E_KEYWORD_TOKEN, start, bidx - start, lineno);
+		}
+		else {
+			c = buff[++bidx];
+			while (c != COMMENT && c != LBRACE && c != RBRACE && c != '\0' \
+				&& c != DQUOTE && c != VAR & c != NEWLINE && c!= EQUAL) {
+				c = buff[++bidx];
+			}
+			error = 1;
+		}
+	}
+
+	TokenMgr_add_token(tokmgr, E_EOF_TOKEN, bidx, 0, 0);
+
+	if (error)
+		printf("Token error: unknown '%.*s' found in line %d\n", (int) (bidx - start), buff + start, lineno);
+
+	return error;
+}
@@ -0,0 +1,75 @@
+/**
+ * Lexing throughput of the table driven tokenizer against the legacy
+ * if/else tokenizer on a large generated script. The table driven tokenizer
+ * is run once per scanner implementation available, see scan.h.
+ * 
+ * Usage: lexbench [lines] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tokenizer.h"
+#include "scan.h"
+#include "bench.h"
+
+int legacy_build_tokens(const char *buff, TokenMgr *tokmgr);
+
+typedef int (*Lexer)(const char *buff, TokenMgr *tokmgr);
+
+// Run lexer over a fresh copy of src and return best time in seconds.
+static double run_lexer(Lexer lex, const char *src, size_t len, int iters, size_t *tok_ct) {
+	char *work = malloc(len + 1);
+	double best = 1e30;
+
+	for (int i = 0; i < iters; i++) {
+		// Each run gets its own copy and pool so neither starts warm.
+		memcpy(work, src, len + 1);
+		InternPool *pool = InternPool_new();
+		TokenMgr *tok_mgr = TokenMgr_new(pool);
+
+		double t0 = bench_now();
+		lex(work, tok_mgr);
+		double el = bench_now() - t0;
+
+		if (el < best)
+			best = el;
+		*tok_ct = tok_mgr->tok_ctr;
+		TokenMgr_free(tok_mgr);
+		InternPool_free(pool);
+	}
+
+	free(work);
+	return best;
+}
+
+int main(int argc, char *argv[]) {
+	size_t lines = argc > 1 ? strtoul(argv[1], NULL, 10) : 500000;
+	int iters = argc > 2 ? atoi(argv[2]) : 5;
+	size_t len = 0;
+	size_t legacy_ct = 0;
+	size_t table_ct = 0;
+	char *src = bench_gen_script(lines, &len);
+
+	static const char *impls[] = { "scalar", "sse2", "avx2" };
+	double mb = len / (1024.0 * 1024.0);
+	double legacy = run_lexer(legacy_build_tokens, src, len, iters, &legacy_ct);
+
+	printf("script: %zu lines, %.2f MiB\n", lines, mb);
+	printf("%-14s %10s %12s %10s\n", "lexer", "tokens", "best (ms)", "MiB/s");
+	printf("%-14s %10zu %12.2f %10.1f\n", "legacy", legacy_ct, legacy * 1e3, mb / legacy);
+
+	for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+		if (scan_select(impls[i]) < 0)
+			continue;
+
+		double table = run_lexer(TokenMgr_build_tokens, src, len, iters, &table_ct);
+		printf("table/%-8s %10zu %12.2f %10.1f\n", impls[i], table_ct, table * 1e3, mb / table);
+
+		if (legacy_ct != table_ct)
+			printf("warning: token counts differ\n");
+	}
+
+	free(src);
+	return 0;
+}
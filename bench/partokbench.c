@@ -0,0 +1,98 @@
+/**
+ * Scaling of parallel tokenizing across thread counts on a large generated
+ * script. Every run is checked against the serial tokenizer, token for token.
+ *
+ * Usage: partokbench [lines] [iterations] [max threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "tokenizer.h"
+#include "bench.h"
+
+// Compare two token streams by type, position, line and value.
+static int same_tokens(TokenMgr *a, TokenMgr *b) {
+	if (a->tok_ctr != b->tok_ctr)
+		return 0;
+
+	for (size_t i = 0; i < a->tok_ctr; i++) {
+		Token *x = &a->toks[i];
+		Token *y = &b->toks[i];
+
+		if (x->type != y->type || x->kwid != y->kwid || x->offset != y->offset
+			|| x->length != y->length || x->lineno != y->lineno
+			|| strcmp(TokenMgr_token_value(a, x), TokenMgr_token_value(b, y)))
+			return 0;
+	}
+
+	return 1;
+}
+
+// Tokenize src with given threads, 1 being the serial tokenizer. Returns best time in seconds.
+static double run_tokenizer(const char *src, unsigned int threads, int iters, TokenMgr *expect, size_t *tok_ct, int *same) {
+	double best = 1e30;
+
+	*same = 1;
+	for (int i = 0; i < iters; i++) {
+		InternPool *pool = InternPool_new();
+		TokenMgr *tok_mgr = TokenMgr_new(pool);
+
+		double t0 = bench_now();
+		if (threads == 1)
+			TokenMgr_build_tokens(src, tok_mgr);
+		else
+			TokenMgr_build_tokens_parallel(src, tok_mgr, threads);
+		double el = bench_now() - t0;
+
+		if (el < best)
+			best = el;
+		*tok_ct = tok_mgr->tok_ctr;
+		if (expect && !same_tokens(expect, tok_mgr))
+			*same = 0;
+
+		TokenMgr_free(tok_mgr);
+		InternPool_free(pool);
+	}
+
+	return best;
+}
+
+int main(int argc, char *argv[]) {
+	size_t lines = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000000;
+	int iters = argc > 2 ? atoi(argv[2]) : 5;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned int max_threads = argc > 3 ? (unsigned int) atoi(argv[3]) : (cores > 0 ? cores : 1);
+	size_t len = 0;
+	size_t tok_ct = 0;
+	int same = 1;
+	char *src = bench_gen_script(lines, &len);
+
+	// Serial tokens are the reference every parallel run is compared with.
+	InternPool *pool = InternPool_new();
+	TokenMgr *expect = TokenMgr_new(pool);
+	TokenMgr_build_tokens(src, expect);
+
+	double mb = len / (1024.0 * 1024.0);
+	double serial = run_tokenizer(src, 1, iters, NULL, &tok_ct, &same);
+
+	printf("script: %zu lines, %.2f MiB, %ld cores\n", lines, mb, cores);
+	printf("%-8s %10s %12s %10s %8s\n", "threads", "tokens", "best (ms)", "MiB/s", "speedup");
+	printf("%-8s %10zu %12.2f %10.1f %8.2f\n", "serial", tok_ct, serial * 1e3, mb / serial, 1.0);
+
+	// Powers of two up to and including max threads.
+	for (unsigned int threads = 2; threads <= max_threads; threads *= 2) {
+		if (threads * 2 > max_threads)
+			threads = max_threads;
+
+		double el = run_tokenizer(src, threads, iters, expect, &tok_ct, &same);
+		printf("%-8u %10zu %12.2f %10.1f %8.2f%s\n", threads, tok_ct, el * 1e3, mb / el, serial / el,
+			same ? "" : "  (tokens differ from serial)");
+	}
+
+	TokenMgr_free(expect);
+	InternPool_free(pool);
+	free(src);
+	return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * SyTable insert and lookup cost from 10k to 1M symbols. Lookups are made by
+ * interned label (SyTable_find_symbol), by plain string (SyTable_get_symbol) and
+ * for labels which were never added. Every lookup is checked to find the symbol
+ * it should.
+ *
+ * Usage: sytablebench [max symbols]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sytable.h"
+#include "bench.h"
+
+// Average distance of index entries from their home bucket.
+static double avg_probe(SyTable *sy_table) {
+	size_t total = 0;
+
+	for (size_t i = 0; i < sy_table->index_cap; i++) {
+		if (sy_table->index[i].slot)
+			total += (i - sy_table->index[i].hash) & (sy_table->index_cap - 1);
+	}
+
+	return sy_table->sym_ctr ? (double) total / sy_table->sym_ctr : 0;
+}
+
+static int run(size_t n) {
+	InternPool *pool = InternPool_new();
+	SyTable *sy_table = SyTable_new(pool);
+	char **names = malloc(n * sizeof(char *));
+	char **interned = malloc(n * sizeof(char *));
+	char **misses = malloc(n * sizeof(char *));
+	char buff[64];
+	size_t bad = 0;
+
+	// Names shaped like script variables, sharing long prefixes.
+	for (size_t i = 0; i < n; i++) {
+		snprintf(buff, sizeof(buff), "deploy_host_%zu", i);
+		names[i] = strdup(buff);
+		interned[i] = InternPool_intern(pool, buff, strlen(buff));
+		snprintf(buff, sizeof(buff), "missing_host_%zu", i);
+		misses[i] = strdup(buff);
+	}
+
+	double t0 = bench_now();
+	for (size_t i = 0; i < n; i++)
+		SyTable_add_symbol(sy_table, interned[i], NULL, i, E_IDN_TYPE);
+
+	double t1 = bench_now();
+	for (size_t i = 0; i < n; i++)
+		bad += SyTable_find_symbol(sy_table, interned[i]) != sy_table->symbols[i];
+
+	double t2 = bench_now();
+	for (size_t i = 0; i < n; i++)
+		bad += SyTable_get_symbol(sy_table, names[i]) != sy_table->symbols[i];
+
+	double t3 = bench_now();
+	for (size_t i = 0; i < n; i++)
+		bad += SyTable_get_symbol(sy_table, misses[i]) != NULL;
+
+	double t4 = bench_now();
+	double ns = 1e9 / n;
+
+	printf("%-9zu %10.1f %10.1f %10.1f %10.1f %8.2f%s\n", n, (t1 - t0) * ns, (t2 - t1) * ns,
+		(t3 - t2) * ns, (t4 - t3) * ns, avg_probe(sy_table),
+		bad ? "  (lookups failed)" : "");
+
+	for (size_t i = 0; i < n; i++) {
+		free(names[i]);
+		free(misses[i]);
+	}
+	free(names);
+	free(interned);
+	free(misses);
+	SyTable_free(sy_table);
+	InternPool_free(pool);
+	return bad != 0;
+}
+
+int main(int argc, char *argv[]) {
+	size_t max = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	int failed = 0;
+
+	printf("%-9s %10s %10s %10s %10s %8s\n", "symbols", "add (ns)", "find (ns)", "get (ns)", "miss (ns)", "probe");
+	for (size_t n = 10000; n <= max; n *= 10)
+		failed |= run(n);
+
+	return failed;
+}
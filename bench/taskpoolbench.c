@@ -0,0 +1,124 @@
+/**
+ * Uneven tasks on the work stealing pool against the same workers each running a
+ * fixed share, which is what the pool does without stealing, and against a single
+ * queue behind one lock. Tasks sleep for their cost, as hosts mostly wait on their
+ * commands, and every one dealt to the first worker is LONG_FACTOR times longer
+ * than the rest, like slow hosts bunching up.
+ *
+ * Usage: taskpoolbench [tasks] [short us] [max workers]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "taskpool.h"
+#include "bench.h"
+
+#define LONG_FACTOR 20
+
+/**
+ * @brief Tasks shared by the baseline threads.
+ *
+ * Central queue threads claim next under lock, fixed share threads run every
+ * workers-th task starting at their own index.
+ */
+typedef struct {
+	double *costs;
+	size_t task_ctr;
+	size_t workers;
+	size_t next;
+	size_t worker_ctr;
+	pthread_mutex_t lock;
+} BaseJob;
+
+// Sleep for a number of seconds.
+static void task_sleep(double secs) {
+	struct timespec ts = { (time_t) secs, (long) ((secs - (time_t) secs) * 1e9) };
+	nanosleep(&ts, NULL);
+}
+
+// Pool task, arg points to its cost.
+static void sleep_task(void *arg, size_t worker) {
+	(void) worker;
+	task_sleep(*(double *) arg);
+}
+
+// Run tasks claimed one at a time from the locked queue.
+static void *central_worker(void *arg) {
+	BaseJob *job = arg;
+
+	for (;;) {
+		pthread_mutex_lock(&job->lock);
+		size_t idx = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if (idx >= job->task_ctr)
+			break;
+		task_sleep(job->costs[idx]);
+	}
+
+	return NULL;
+}
+
+// Run the share of tasks a worker is dealt.
+static void *fixed_worker(void *arg) {
+	BaseJob *job = arg;
+	size_t self = __atomic_fetch_add(&job->worker_ctr, 1, __ATOMIC_RELAXED);
+
+	for (size_t idx = self; idx < job->task_ctr; idx += job->workers)
+		task_sleep(job->costs[idx]);
+
+	return NULL;
+}
+
+// Run every task on workers threads of the baseline, return the elapsed seconds.
+static double run_base(void *(*worker)(void *), double *costs, size_t task_ctr, size_t workers) {
+	BaseJob job = { costs, task_ctr, workers, 0, 0, PTHREAD_MUTEX_INITIALIZER };
+	pthread_t *threads = malloc(workers * sizeof(pthread_t));
+	double t0 = bench_now();
+
+	for (size_t i = 0; i < workers; i++)
+		pthread_create(&threads[i], NULL, worker, &job);
+	for (size_t i = 0; i < workers; i++)
+		pthread_join(threads[i], NULL);
+
+	free(threads);
+	return bench_now() - t0;
+}
+
+int main(int argc, char *argv[]) {
+	size_t task_ctr = argc > 1 ? strtoul(argv[1], NULL, 10) : 800;
+	double short_secs = (argc > 2 ? atof(argv[2]) : 200) / 1e6;
+	size_t max_workers = argc > 3 ? strtoul(argv[3], NULL, 10) : 8;
+	double *costs = malloc((task_ctr + 1) * sizeof(double));
+
+	printf("%7s %10s %10s %10s %10s %12s\n", "workers", "fixed ms", "central ms", "pool ms", "stolen", "steal fails");
+	for (size_t workers = 2; workers <= max_workers; workers *= 2) {
+		for (size_t i = 0; i < task_ctr; i++)
+			costs[i] = i % workers == 0 ? short_secs * LONG_FACTOR : short_secs;
+
+		double fixed = run_base(fixed_worker, costs, task_ctr, workers);
+		double central = run_base(central_worker, costs, task_ctr, workers);
+
+		TaskPool *pool = TaskPool_new(workers);
+		TaskPoolStats stats;
+		double t0 = bench_now();
+
+		if (!pool)
+			return 1;
+		for (size_t i = 0; i < task_ctr; i++)
+			TaskPool_submit(pool, sleep_task, &costs[i]);
+		TaskPool_wait(pool);
+		double pooled = bench_now() - t0;
+
+		TaskPool_stats(pool, &stats, NULL);
+		TaskPool_free(pool);
+
+		printf("%7zu %10.1f %10.1f %10.1f %10zu %12zu%s\n", workers, fixed * 1e3, central * 1e3,
+			pooled * 1e3, stats.stolen, stats.steal_fails, stats.run != task_ctr ? "  (bad count)" : "");
+	}
+
+	free(costs);
+	return 0;
+}
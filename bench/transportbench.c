@@ -0,0 +1,61 @@
+/**
+ * Cost of running a group of short commands through the local transports, one
+ * process per command against a single shell per session. Every group opens a
+ * session, runs GROUP_SIZE commands printing a line each and closes it. Output is
+ * compared to the expected line.
+ *
+ * Usage: transportbench [groups]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "transport.h"
+#include "bench.h"
+
+#define GROUP_SIZE 50
+
+// Run groups of GROUP_SIZE commands, return the number of bad results.
+static size_t run_groups(Transport *transport, size_t groups) {
+	VString out = VString_new();
+	size_t bad = 0;
+
+	for (size_t g = 0; g < groups; g++) {
+		TransportSession *session = Transport_open(transport, TRANSPORT_LOCALHOST);
+
+		for (size_t c = 0; c < GROUP_SIZE; c++) {
+			TransportResult res = TransportResult_new();
+
+			bad += !session || Transport_run(session, "echo ok", &res) == -1 || res.status != 0
+				|| strcmp(VRope_flatten(&res.out, &out), "ok\n") != 0;
+			TransportResult_free(&res);
+		}
+
+		Transport_close(session);
+	}
+
+	VString_free(&out);
+	return bad;
+}
+
+int main(int argc, char *argv[]) {
+	size_t groups = argc > 1 ? strtoul(argv[1], NULL, 10) : 20;
+	Transport *transports[] = { Transport_local(), Transport_local_session() };
+	int failed = 0;
+
+	if (!groups)
+		groups = 1;
+
+	printf("%-14s %12s %12s\n", "transport", "cmds/s", "ms/group");
+	for (size_t t = 0; t < 2; t++) {
+		double t0 = bench_now();
+		size_t bad = run_groups(transports[t], groups);
+		double t1 = bench_now() - t0;
+
+		failed |= bad != 0;
+		printf("%-14s %12.0f %12.2f%s\n", transports[t]->name, groups * GROUP_SIZE / t1,
+			t1 * 1e3 / groups, bad ? "  (bad result)" : "");
+	}
+
+	return failed;
+}
@@ -0,0 +1,164 @@
+/**
+ * Tree walking executor against the bytecode VM on an arithmetic heavy
+ * generated script. Both are run once on separate symbol tables first and the
+ * resulting variables compared.
+ *
+ * Usage: vmbench [lines] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tokenizer.h"
+#include "parser.h"
+#include "nexec.h"
+#include "vm.h"
+#include "bench.h"
+
+// Distinct variables, kept small so symbol lookup doesn't dominate the tree walker.
+#define VARS 16
+
+// Templates cycled through, %zu is replaced by variable number then a constant.
+static const char *Arith_Lines[] = {
+	"$v%zu = %zu + 23 * 4 - 7\n",
+	"$v%zu = $v3 * 2 + $v5 / 3 - %zu\n",
+	"$v%zu = $v1 - $v2 + %zu * 2 * $v7\n",
+	"$v%zu = $v4 * $v6 >= $v0 + %zu\n",
+	"$v%zu = $v8 + %zu * $v9 - 3 / 5\n",
+	"$v%zu = $v10 == $v11 + %zu - $v12\n",
+};
+
+/**
+ * @brief Parsed script ready to execute.
+ */
+typedef struct {
+	InternPool *pool;
+	SyTable *sy_table;
+	Error *err_handle;
+	FlatAst *ast;
+	NexecMgr *nexec_mgr;
+	Bytecode *code;
+} Script;
+
+// Generate the arithmetic script, every variable is assigned before any is read.
+static char *gen_arith_script(size_t lines) {
+	size_t cap = (lines + VARS) * 64 + 256;
+	size_t n = 0;
+	size_t tmpl_ct = sizeof(Arith_Lines) / sizeof(Arith_Lines[0]);
+	char *buff = malloc(cap);
+
+	for (size_t v = 0; v < VARS; v++)
+		n += snprintf(buff + n, cap - n, "$v%zu = %zu\n", v, v + 1);
+
+	for (size_t i = 0; i < lines; i++)
+		n += snprintf(buff + n, cap - n, Arith_Lines[i % tmpl_ct], i % VARS, i % 97);
+
+	return buff;
+}
+
+// Tokenize, parse, lower and compile src.
+static int load_script(Script *s, const char *src) {
+	TokenMgr *tok_mgr;
+	NodeMgr *node_mgr = NodeMgr_new();
+
+	s->pool = InternPool_new();
+	s->sy_table = SyTable_new(s->pool);
+	s->err_handle = Error_new();
+	s->ast = FlatAst_new();
+	tok_mgr = TokenMgr_new(s->pool);
+
+	int err = TokenMgr_build_tokens(src, tok_mgr);
+	if (!err) {
+		ParserMgr *par_mgr = ParseMgr_init(tok_mgr, s->sy_table, node_mgr, s->err_handle);
+		Parser_parse(par_mgr);
+		ParserMgr_free(par_mgr);
+		err = s->err_handle->error_ctr || FlatAst_lower(s->ast, node_mgr, s->sy_table);
+	}
+
+	NodeMgr_free(node_mgr);
+	TokenMgr_free(tok_mgr);
+	s->nexec_mgr = Nexec_init(s->sy_table, s->ast, s->err_handle);
+	s->code = err ? NULL : Bytecode_compile(s->ast);
+	return s->code ? 0 : -1;
+}
+
+static void free_script(Script *s) {
+	if (s->code)
+		Bytecode_free(s->code);
+	NexecMgr_free(s->nexec_mgr);
+	Error_free(s->err_handle);
+	SyTable_free(s->sy_table);
+	FlatAst_free(s->ast);
+	InternPool_free(s->pool);
+}
+
+// Execute every root with the tree walker.
+static void run_tree(Script *s) {
+	for (size_t i = 0; i < s->ast->root_ctr; i++)
+		Nexec_exec(s->nexec_mgr, s->ast->roots[i]);
+}
+
+// Compare the values of every variable.
+static int same_symbols(SyTable *a, SyTable *b) {
+	if (a->sym_ctr != b->sym_ctr)
+		return 0;
+
+	VString x_buff = VString_new();
+	VString y_buff = VString_new();
+	int same = 1;
+
+	for (size_t i = 0; i < a->sym_ctr && same; i++) {
+		Value *x = &a->symbols[i]->val;
+		Value *y = &b->symbols[i]->val;
+		same = !strcmp(a->symbols[i]->label, b->symbols[i]->label) && x->type == y->type
+			&& (x->type == E_NONE_VALUE || !strcmp(Value_to_string(x, &x_buff), Value_to_string(y, &y_buff)));
+	}
+
+	VString_free(&x_buff);
+	VString_free(&y_buff);
+	return same;
+}
+
+int main(int argc, char *argv[]) {
+	size_t lines = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+	int iters = argc > 2 ? atoi(argv[2]) : 10;
+	char *src = gen_arith_script(lines);
+	Script tree = { 0 };
+	Script vm = { 0 };
+	double best_tree = 1e30;
+	double best_vm = 1e30;
+
+	if (load_script(&tree, src) || load_script(&vm, src)) {
+		fprintf(stderr, "vmbench: failed to compile script\n");
+		return 1;
+	}
+
+	run_tree(&tree);
+	Vm_run(vm.nexec_mgr, vm.code);
+	int same = same_symbols(tree.sy_table, vm.sy_table);
+
+	for (int i = 0; i < iters; i++) {
+		double t0 = bench_now();
+		run_tree(&tree);
+		double t1 = bench_now();
+		Vm_run(vm.nexec_mgr, vm.code);
+		double t2 = bench_now();
+
+		if (t1 - t0 < best_tree)
+			best_tree = t1 - t0;
+		if (t2 - t1 < best_vm)
+			best_vm = t2 - t1;
+	}
+
+	printf("script: %zu statements, %zu nodes, %zu instructions, stack %zu\n",
+		vm.ast->root_ctr, vm.ast->node_ctr, vm.code->code_ctr, vm.code->stack_max);
+	printf("%-10s %12s %14s %8s\n", "executor", "best (ms)", "stmts/s", "speedup");
+	printf("%-10s %12.2f %14.0f %8.2f\n", "tree", best_tree * 1e3, vm.ast->root_ctr / best_tree, 1.0);
+	printf("%-10s %12.2f %14.0f %8.2f%s\n", "vm", best_vm * 1e3, vm.ast->root_ctr / best_vm, best_tree / best_vm,
+		same ? "" : "  (variables differ from tree)");
+
+	free_script(&tree);
+	free_script(&vm);
+	free(src);
+	return !same;
+}
@@ -0,0 +1,135 @@
+/**
+ * Capturing large command output into a VString against a VRope. Output arrives
+ * in reads of READ_SIZE bytes, as from a pipe, and is then split into lines. The
+ * VString grows by doubling so earlier output is copied again on every grow, the
+ * VRope is read into directly and never moves. Line counts are compared, which
+ * also keeps the work from being optimized away.
+ *
+ * Usage: vropebench [megabytes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vstring.h"
+#include "vrope.h"
+#include "bench.h"
+
+#define READ_SIZE 4096
+
+// Simulated command output.
+static char *Output;
+static size_t Output_len;
+static size_t Output_lines;
+
+// Build output of roughly mb megabytes made of log like lines.
+static void build_output(size_t mb) {
+	VString out = VString_new();
+	char line[128];
+
+	for (size_t i = 0; out.str_size < mb << 20; i++) {
+		int n = snprintf(line, sizeof(line), "%06zu web-%02zu.example.com: service %s ok in %zums\n",
+			i, i % 64, i % 3 ? "nginx" : "postgresql", i % 997);
+		VString_pushn(&out, line, n);
+		Output_lines++;
+	}
+
+	Output_len = out.str_size;
+	Output = malloc(Output_len);
+	memcpy(Output, VString_str(&out), Output_len);
+	VString_free(&out);
+}
+
+// Read output into a VString.
+static void capture_vstring(VString *vstr) {
+	for (size_t pos = 0; pos < Output_len; pos += READ_SIZE) {
+		size_t n = Output_len - pos < READ_SIZE ? Output_len - pos : READ_SIZE;
+		VString_pushn(vstr, Output + pos, n);
+	}
+}
+
+// Read output straight into the spare room of a VRope.
+static void capture_vrope(VRope *rope) {
+	for (size_t pos = 0; pos < Output_len; ) {
+		size_t avail;
+		char *buff = VRope_spare(rope, 1, &avail);
+		size_t n = Output_len - pos;
+
+		if (n > avail)
+			n = avail;
+		if (n > READ_SIZE)
+			n = READ_SIZE;
+		memcpy(buff, Output + pos, n);
+		VRope_commit(rope, n);
+		pos += n;
+	}
+}
+
+// Count the lines of a VString.
+static size_t lines_vstring(VString *vstr) {
+	char *it = VString_str(vstr);
+	char *end = it + vstr->str_size;
+	size_t lines = 0;
+
+	while (it < end) {
+		char *nl = memchr(it, '\n', end - it);
+		lines++;
+		it = nl ? nl + 1 : end;
+	}
+
+	return lines;
+}
+
+// Count the lines of a VRope.
+static size_t lines_vrope(VRope *rope) {
+	VRopeIter it = VRope_iter(rope);
+	VRopeSpan line;
+	size_t lines = 0;
+
+	while (VRope_next_line(&it, &line))
+		lines++;
+
+	return lines;
+}
+
+int main(int argc, char *argv[]) {
+	size_t mb = argc > 1 ? strtoul(argv[1], NULL, 10) : 64;
+	double best[4] = { 1e30, 1e30, 1e30, 1e30 };
+	int failed = 0;
+
+	build_output(mb ? mb : 1);
+
+	for (int r = 0; r < 5; r++) {
+		VString vstr = VString_new();
+		VRope rope = VRope_new();
+		double t0 = bench_now();
+
+		capture_vstring(&vstr);
+		double t1 = bench_now();
+		failed |= lines_vstring(&vstr) != Output_lines;
+		double t2 = bench_now();
+		capture_vrope(&rope);
+		double t3 = bench_now();
+		failed |= lines_vrope(&rope) != Output_lines;
+		double t4 = bench_now();
+
+		double t[4] = { t1 - t0, t2 - t1, t3 - t2, t4 - t3 };
+		for (int i = 0; i < 4; i++)
+			if (t[i] < best[i])
+				best[i] = t[i];
+
+		VString_free(&vstr);
+		VRope_free(&rope);
+	}
+
+	double size = Output_len / (double) (1 << 20);
+	printf("%zu bytes, %zu lines\n", Output_len, Output_lines);
+	printf("%-8s %12s %12s\n", "", "capture MB/s", "lines MB/s");
+	printf("%-8s %12.0f %12.0f\n", "vstring", size / best[0], size / best[1]);
+	printf("%-8s %12.0f %12.0f\n", "vrope", size / best[2], size / best[3]);
+	if (failed)
+		printf("(bad result)\n");
+
+	free(Output);
+	return failed;
+}
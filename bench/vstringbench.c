@@ -0,0 +1,191 @@
+/**
+ * VString throughput on the short lived strings the interpreter builds, i.e
+ * variable names, formatted numbers and error hints, plus a long string to
+ * cover growing. The template case expands a command template of TMPL_KEYS
+ * variables, calling VString_replace per variable. Every operation starts from a fresh VString and frees it, as
+ * the callers do. Every result is compared to the expected string, which also
+ * keeps the work from being optimized away.
+ *
+ * Usage: vstringbench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vstring.h"
+#include "bench.h"
+
+// Words pushed by the long case.
+static char *Words[] = { "deploy ", "web-01 ", "uptime ", "$host ", "restart " };
+
+#define TMPL_KEYS 40
+
+// Expected result of the long case.
+static char Long[512];
+
+// Command template, its variables, their values and the expected expansion.
+static char Tmpl[4096];
+static char *Keys[TMPL_KEYS];
+static char *Values[TMPL_KEYS];
+static char Expanded[8192];
+
+typedef struct {
+	const char *name;
+	size_t (*run)(size_t iters);
+	size_t scale;
+} Case;
+
+// Set a short string.
+static size_t case_set(size_t iters) {
+	size_t bad = 0;
+
+	for (size_t i = 0; i < iters; i++) {
+		VString vstr = VString_new();
+		VString_set(&vstr, "hostname");
+		bad += strcmp(VString_str(&vstr), "hostname") != 0;
+		VString_free(&vstr);
+	}
+
+	return bad;
+}
+
+// Build a short name char by char, as variable names are.
+static size_t case_pushc(size_t iters) {
+	size_t bad = 0;
+
+	for (size_t i = 0; i < iters; i++) {
+		VString vstr = VString_new();
+		for (const char *c = "$deploy_user"; *c; c++)
+			VString_pushc(&vstr, *c);
+		bad += strcmp(VString_str(&vstr), "$deploy_user") != 0;
+		VString_free(&vstr);
+	}
+
+	return bad;
+}
+
+// Append a few short strings.
+static size_t case_pushs(size_t iters) {
+	size_t bad = 0;
+
+	for (size_t i = 0; i < iters; i++) {
+		VString vstr = VString_new();
+		VString_pushs(&vstr, "[");
+		VString_pushs(&vstr, "1, 2");
+		VString_pushs(&vstr, ", 3]");
+		bad += strcmp(VString_str(&vstr), "[1, 2, 3]") != 0;
+		VString_free(&vstr);
+	}
+
+	return bad;
+}
+
+// Replace a variable inside a short string.
+static size_t case_replace(size_t iters) {
+	size_t bad = 0;
+
+	for (size_t i = 0; i < iters; i++) {
+		VString vstr = VString_create("hi $u ok", 0);
+		VString_replace(&vstr, "$u", "sam");
+		bad += strcmp(VString_str(&vstr), "hi sam ok") != 0;
+		VString_free(&vstr);
+	}
+
+	return bad;
+}
+
+// Grow a string to a few hundred bytes, always spilling to the heap.
+static size_t case_long(size_t iters) {
+	size_t bad = 0;
+
+	for (size_t i = 0; i < iters; i++) {
+		VString vstr = VString_new();
+		for (size_t w = 0; w < 40; w++)
+			VString_pushs(&vstr, Words[w % 5]);
+		bad += strcmp(VString_str(&vstr), Long) != 0;
+		VString_free(&vstr);
+	}
+
+	return bad;
+}
+
+// Expand the template one variable at a time.
+static size_t case_tmpl_each(size_t iters) {
+	size_t bad = 0;
+
+	for (size_t i = 0; i < iters; i++) {
+		VString vstr = VString_create(Tmpl, 0);
+		for (size_t k = 0; k < TMPL_KEYS; k++)
+			VString_replace(&vstr, Keys[k], Values[k]);
+		bad += strcmp(VString_str(&vstr), Expanded) != 0;
+		VString_free(&vstr);
+	}
+
+	return bad;
+}
+
+// Build the template, every variable appears twice between literal text.
+static void build_template(void) {
+	char buff[64];
+
+	for (size_t k = 0; k < TMPL_KEYS; k++) {
+		snprintf(buff, sizeof(buff), "$var_%02zu", k);
+		Keys[k] = strdup(buff);
+		snprintf(buff, sizeof(buff), "value-%zu.example.com", k);
+		Values[k] = strdup(buff);
+	}
+
+	for (size_t r = 0; r < 2; r++) {
+		for (size_t k = 0; k < TMPL_KEYS; k++) {
+			snprintf(buff, sizeof(buff), "--opt-%zu=", k);
+			strcat(Tmpl, buff);
+			strcat(Tmpl, Keys[k]);
+			strcat(Tmpl, " ");
+			strcat(Expanded, buff);
+			strcat(Expanded, Values[k]);
+			strcat(Expanded, " ");
+		}
+	}
+}
+
+int main(int argc, char *argv[]) {
+	size_t iters = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000000;
+	Case cases[] = {
+		{ "set", case_set, 1 },
+		{ "pushc", case_pushc, 1 },
+		{ "pushs", case_pushs, 1 },
+		{ "replace", case_replace, 1 },
+		{ "long", case_long, 1 },
+		{ "tmpl_each", case_tmpl_each, 200 }
+	};
+	int failed = 0;
+
+	for (size_t w = 0; w < 40; w++)
+		strcat(Long, Words[w % 5]);
+	build_template();
+
+	printf("%-9s %10s %12s\n", "case", "ns/op", "ops/s");
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		size_t n = iters / cases[c].scale;
+		double best = 1e30;
+		size_t bad = 0;
+
+		for (int r = 0; r < 5; r++) {
+			double t0 = bench_now();
+			bad += cases[c].run(n);
+			double t = bench_now() - t0;
+			if (t < best)
+				best = t;
+		}
+
+		failed |= bad != 0;
+		printf("%-9s %10.1f %12.0f%s\n", cases[c].name, best * 1e9 / n, n / best,
+			bad ? "  (bad result)" : "");
+	}
+
+	for (size_t k = 0; k < TMPL_KEYS; k++) {
+		free(Keys[k]);
+		free(Values[k]);
+	}
+	return failed;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file arena.h
+ * @author Sayed Sadeed
+ * @brief Bump allocator handing out memory from large contiguous blocks.
+ * 
+ * Allocations are never freed individually. Everything allocated from an
+ * Arena is released at once by Arena_reset() or Arena_free().
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define INIT_ARENA_BLOCK_SIZE 65536
+
+/**
+ * @brief Single block of arena memory. Blocks are chained newest first.
+ */
+typedef struct ArenaBlock {
+	struct ArenaBlock *prev;
+	size_t used;
+	size_t cap;
+	max_align_t data[];
+} ArenaBlock;
+
+/**
+ * @brief Arena owning a chain of blocks.
+ */
+typedef struct {
+	ArenaBlock *head;
+	size_t block_size;
+	size_t total;
+} Arena;
+
+/**
+ * @brief Create malloc'ed Arena instance.
+ * 
+ * No block is allocated until the first allocation.
+ * 
+ * @param block_size Size of each block, 0 for INIT_ARENA_BLOCK_SIZE.
+ * @return New instance of Arena or NULL if failed.
+ */
+Arena *Arena_new(size_t block_size);
+
+/**
+ * @brief Allocate memory suitably aligned for any type.
+ * 
+ * @param arena Arena instance.
+ * @param size Number of bytes.
+ * @return Pointer to uninitialised memory or NULL if failed.
+ */
+void *Arena_alloc(Arena *arena, size_t size);
+
+/**
+ * @brief Allocate memory with no alignment, useful for strings.
+ * 
+ * @param arena Arena instance.
+ * @param size Number of bytes.
+ * @return Pointer to uninitialised memory or NULL if failed.
+ */
+void *Arena_alloc_bytes(Arena *arena, size_t size);
+
+/**
+ * @brief Release every allocation made from the arena.
+ * 
+ * The most recent block is kept for reuse, all others are freed.
+ * 
+ * @param arena Arena instance.
+ */
+void Arena_reset(Arena *arena);
+
+/**
+ * @brief Free all blocks as well as the Arena itself.
+ * 
+ * @param arena Arena instance.
+ */
+void Arena_free(Arena *arena);
+
+#endif
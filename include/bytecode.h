@@ -0,0 +1,119 @@
+/**
+ * @file bytecode.h
+ * @author Sayed Sadeed
+ * @brief Compiler from FlatAst trees to bytecode executed by the VM, see vm.h.
+ *
+ * Every root in a FlatAst compiles to a statement, a BC_STMT instruction followed
+ * by the instructions of the root and closed by BC_END_STMT. Expressions are
+ * evaluated on a 64 bit integer stack whose depth is known once compiled.
+ *
+ * Operands are decoded while compiling, so integer literals and the values of plain
+ * strings are pushed as immediates instead of being converted on each evaluation.
+ * Variables are referred to by the SyTable slots FlatAst_lower() resolved them to,
+ * and strings by their index into the strs of the FlatAst compiled from.
+ */
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stddef.h>
+#include "flatast.h"
+
+/**
+ * Opcodes, a is the first operand and b the second.
+ *
+ *  BC_HALT         stop execution.
+ *  BC_STMT         start of statement compiled from root a, used for error hints.
+ *  BC_END_STMT     end of statement, report errors.
+ *  BC_PUSH_INT     push immediate a | b << 32.
+ *  BC_PUSH_VAR     push the integer value of variable in slot a, named by string b.
+ *  BC_PUSH_MIXSTR  push the ascii value of mixed string a once expanded.
+ *  BC_ADD .. BC_GE pop rhs then lhs and push the result.
+ *  BC_PRINT_INT    pop and print.
+ *  BC_PRINT_STR    print string a.
+ *  BC_PRINT_VAR    print variable in slot a, named by string b.
+ *  BC_PRINT_MIXSTR print mixed string a once expanded.
+ *  BC_STORE_INT    pop and assign to variable in slot a.
+ *  BC_STORE_LIT    pop and assign to variable in slot a, printed as integer literal b.
+ *  BC_STORE_BOOL   pop and assign to variable in slot a as a boolean.
+ *  BC_STORE_STR    assign string b to variable in slot a.
+ *  BC_STORE_VAR    assign the value of variable in slot b to variable in slot a.
+ *  BC_STORE_MIXSTR assign mixed string b once expanded to variable in slot a.
+ *  BC_STORE_ARRAY  assign the array literal at node b to variable in slot a.
+ *  BC_GROUP        run the commands of the group at root a, see Nexec_group_node().
+ */
+#define BC_OPCODES(X) \
+	X(BC_HALT) \
+	X(BC_STMT) \
+	X(BC_END_STMT) \
+	X(BC_PUSH_INT) \
+	X(BC_PUSH_VAR) \
+	X(BC_PUSH_MIXSTR) \
+	X(BC_ADD) \
+	X(BC_SUB) \
+	X(BC_MUL) \
+	X(BC_DIV) \
+	X(BC_EQ) \
+	X(BC_NE) \
+	X(BC_LT) \
+	X(BC_LE) \
+	X(BC_GT) \
+	X(BC_GE) \
+	X(BC_PRINT_INT) \
+	X(BC_PRINT_STR) \
+	X(BC_PRINT_VAR) \
+	X(BC_PRINT_MIXSTR) \
+	X(BC_STORE_INT) \
+	X(BC_STORE_LIT) \
+	X(BC_STORE_BOOL) \
+	X(BC_STORE_STR) \
+	X(BC_STORE_VAR) \
+	X(BC_STORE_MIXSTR) \
+	X(BC_STORE_ARRAY) \
+	X(BC_GROUP)
+
+#define BC_ENUM(op) op,
+
+enum Opcode {
+	BC_OPCODES(BC_ENUM)
+	BC_OPCODE_COUNT
+};
+
+/**
+ * @brief Single instruction.
+ */
+typedef struct {
+	unsigned char op;
+	unsigned int a;
+	unsigned int b;
+} Instr;
+
+/**
+ * @brief Compiled program.
+ *
+ * Strings are borrowed from the FlatAst which has to outlive the Bytecode.
+ */
+typedef struct {
+	Instr *code;
+	size_t code_ctr;
+	size_t code_cap;
+	FlatAst *ast;
+	size_t stack_max;
+} Bytecode;
+
+/**
+ * @brief Compile every root of a FlatAst.
+ *
+ * @param ast FlatAst instance.
+ * @return New instance of Bytecode or NULL if failed.
+ */
+Bytecode *Bytecode_compile(FlatAst *ast);
+
+/**
+ * @brief Free Bytecode instance.
+ *
+ * @param code Bytecode instance.
+ */
+void Bytecode_free(Bytecode *code);
+
+#endif
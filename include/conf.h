@@ -18,6 +18,17 @@
 #define INIT_NODEMGR_SIZE 100
 #define INIT_TOKMGR_TOKS_SIZE 40
 
+/**
+ * Parallel tokenizing, see TokenMgr_build_tokens_parallel().
+ * 
+ * PARTOK_MIN_CHUNK smallest chunk of source worth handing to a thread.
+ * PARTOK_CHUNKS_PER_WORKER chunks per thread so uneven chunks still balance out.
+ * PARTOK_BRACE_WINDOW bytes looked ahead of a chunk boundary for a closing brace.
+ */
+#define PARTOK_MIN_CHUNK (64 * 1024)
+#define PARTOK_CHUNKS_PER_WORKER 4
+#define PARTOK_BRACE_WINDOW 4096
+
 /**
  * Fixed structure sizing.
  * 
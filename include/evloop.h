@@ -0,0 +1,50 @@
+/**
+ * @file evloop.h
+ * @author Sayed Sadeed
+ * @brief Single threaded event loop running a list of commands on many hosts at once.
+ *
+ * Every active host has a session whose current command was spawned through
+ * the transport start function. The loop waits on one epoll instance for any of
+ * their stdout and stderr pipes to become readable, appending what arrives to the
+ * output of that host, and for any of them to exit, through a pidfd where the kernel
+ * has them. A command is done once it exited and both pipes reached end of file, the
+ * next one is then started or, once the host is done, the next host is. Deadlines of
+ * running commands are kept in a min heap with a single timerfd armed for the earliest,
+ * commands running past it are killed.
+ *
+ * Unlike running hosts on threads, an idle host costs only its descriptors, so the
+ * number of hosts active at once is bounded by descriptors rather than threads. It is
+ * lowered to what the RLIMIT_NOFILE soft limit leaves room for, raise it with ulimit -n
+ * to run more.
+ */
+
+#ifndef EVLOOP_H
+#define EVLOOP_H
+
+#include <stddef.h>
+#include "executor.h"
+#include "transport.h"
+
+#define EVLOOP_TIMEOUT_STATUS TRANSPORT_TIMEOUT_STATUS
+
+/**
+ * @brief Run a list of commands on every host.
+ *
+ * Commands run in order on each host through its own session, stopping at the
+ * first which fails, as Executor_run_host() does. Results are filled in as for
+ * Executor_run_group(), a command killed once past its timeout ending with status
+ * EVLOOP_TIMEOUT_STATUS.
+ *
+ * @param transport Transport instance, must have a start function.
+ * @param cmds Commands to run.
+ * @param cmd_ctr Number of commands.
+ * @param hosts Results, host set beforehand and res empty.
+ * @param host_ctr Number of hosts.
+ * @param max_active Number of hosts run at once.
+ * @param timeout_ms Time a command may run for in milliseconds, 0 for no limit.
+ * @return 0 if successful otherwise -1 if the loop could not be set up.
+ */
+int EvLoop_run(Transport *transport, char **cmds, size_t cmd_ctr, HostResult *hosts,
+				size_t host_ctr, size_t max_active, unsigned int timeout_ms);
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file executor.h
+ * @author Sayed Sadeed
+ * @brief Runs the commands of a group on one host or fanned out across an inventory.
+ *
+ * Transports which can start commands without waiting for them, see Transport start,
+ * have every host driven by a single thread through EvLoop_run(). Otherwise every
+ * host is run on a copy of the NexecMgr, see Nexec_fork(), with its own session,
+ * output and errors. The FlatAst and SyTable are only read, so they are shared by
+ * every host without being parsed again. Each host of a group is then a task of a
+ * work stealing pool of forks threads, see TaskPool, kept from one group to the next.
+ * Either way results are kept per host, in inventory order.
+ */
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <stdio.h>
+#include "nexec.h"
+#include "inventory.h"
+#include "transport.h"
+
+#define EXECUTOR_DEFAULT_FORKS 5
+
+/**
+ * @brief Outcome of running a group on a host.
+ *
+ * res holds the output of every command run, one after the other, and the
+ * status of the last. cmd_ctr is the number of commands run, the group stopping
+ * at the first which failed. secs is the time from connecting to the host to its
+ * last command being done.
+ */
+typedef struct {
+	const char *host;
+	TransportResult res;
+	size_t cmd_ctr;
+	double secs;
+} HostResult;
+
+/**
+ * @brief Run the commands of a group on a single host.
+ *
+ * Commands run in order through a single session of nexec_mgr->transport, each
+ * limited to nexec_mgr->timeout_ms, stopping at the first which fails, which is
+ * reported to nexec_mgr->err_handle.
+ *
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @param group Index of group node inside the FlatAst.
+ * @param host Result to fill in, host set beforehand.
+ * @return 0 if every command succeeded otherwise -1.
+ */
+int Executor_run_host(NexecMgr *nexec_mgr, FlatIdx group, HostResult *host);
+
+/**
+ * @brief Run the commands of a group on a list of hosts.
+ *
+ * Up to nexec_mgr->forks hosts run at once, either on the event loop or as tasks
+ * of nexec_mgr->pool, started on first use. Either way commands running past
+ * nexec_mgr->timeout_ms are killed. Errors of every host are moved to nexec_mgr->err_handle
+ * in the order of hosts once all are done.
+ *
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @param group Index of group node inside the FlatAst.
+ * @param hosts Results to fill in, host set beforehand and res empty.
+ * @param host_ctr Number of hosts.
+ * @return 0 if every host was run, whether or not it succeeded, otherwise -1.
+ */
+int Executor_run_hosts(NexecMgr *nexec_mgr, FlatIdx group, HostResult *hosts, size_t host_ctr);
+
+/**
+ * @brief Run the commands of a group on every host of nexec_mgr->inventory.
+ *
+ * See Executor_run_hosts().
+ *
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @param group Index of group node inside the FlatAst.
+ * @return Result of each host in inventory order, see Executor_free_results(), or NULL if failed.
+ */
+HostResult *Executor_run_group(NexecMgr *nexec_mgr, FlatIdx group);
+
+/**
+ * @brief Write the results of a group, host by host.
+ *
+ * Every host is introduced by a "host | ok" or "host | failed (status)" line on
+ * out followed by its output, stderr going to err.
+ *
+ * @param results Results of Executor_run_group().
+ * @param n Number of results.
+ * @param out Stream for the summary and stdout of commands.
+ * @param err Stream for stderr of commands.
+ */
+void Executor_report(HostResult *results, size_t n, FILE *out, FILE *err);
+
+/**
+ * @brief Free results of Executor_run_group().
+ *
+ * @param results Results.
+ * @param n Number of results.
+ */
+void Executor_free_results(HostResult *results, size_t n);
+
+#endif
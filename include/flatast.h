@@ -0,0 +1,117 @@
+/**
+ * @file flatast.h
+ * @author Sayed Sadeed
+ * @brief Compact index based encoding of the AST used for execution.
+ *
+ * The parser builds a pointer tree inside NodeMgr which is then lowered into
+ * a FlatAst. Nodes live in parallel arrays (types, keyword ids, values and two 32 bit
+ * operands) indexed by node, so walking a tree touches a few small dense arrays
+ * instead of chasing pointers. Children are always stored before their parent.
+ *
+ * Operands by node type:
+ *  - binary, compare and assignment nodes: lhs and rhs are the left and right nodes.
+ *  - function nodes: lhs is the argument.
+ *  - array and group nodes: lhs is the first entry in kids, rhs the number of entries.
+ *  - identifier nodes: rhs is the slot of the variable in SyTable, see SyTable_get_slot(),
+ *    FLAT_NONE if it was never declared.
+ *  - everything else: unused, FLAT_NONE.
+ *
+ * Values are indices into strs, a table of the distinct interned strings used by the
+ * tree. No array holds a pointer so a FlatAst can be written out and mapped back as is.
+ */
+
+#ifndef FLATAST_H
+#define FLATAST_H
+
+#include <stddef.h>
+#include "node.h"
+#include "sytable.h"
+
+#define FLAT_NONE 0xffffffffu
+
+// Index of a node inside FlatAst.
+typedef unsigned int FlatIdx;
+
+/**
+ * @brief Flat AST, see file description for layout.
+ *
+ * When borrowed is set the node, kid and root arrays belong to someone else, i.e a
+ * mapped cache file, and are left alone when freeing. strs is always owned.
+ */
+typedef struct {
+	unsigned char *types;
+	unsigned char *kwids;
+	unsigned int *values;
+	FlatIdx *lhs;
+	FlatIdx *rhs;
+	FlatIdx *kids;
+	FlatIdx *roots;
+	char **strs;
+	size_t node_ctr;
+	size_t node_cap;
+	size_t kid_ctr;
+	size_t kid_cap;
+	size_t root_ctr;
+	size_t root_cap;
+	size_t str_ctr;
+	size_t str_cap;
+	int borrowed;
+} FlatAst;
+
+/**
+ * @brief Create malloc'ed empty FlatAst instance.
+ *
+ * @return New instance of FlatAst or NULL if failed.
+ */
+FlatAst *FlatAst_new(void);
+
+/**
+ * @brief Lower every tree in NodeMgr, appending them as roots.
+ *
+ * Identifiers are resolved to the slots of their symbols, so every symbol has to
+ * be declared beforehand, i.e once parsing is done. Once lowered NodeMgr is no
+ * longer needed for execution and may be freed.
+ *
+ * @param ast FlatAst instance.
+ * @param node_mgr NodeMgr holding the parsed trees.
+ * @param sy_table SyTable symbols were declared in, node values were interned into its pool.
+ * @return 0 if successful otherwise -1.
+ */
+int FlatAst_lower(FlatAst *ast, NodeMgr *node_mgr, SyTable *sy_table);
+
+/**
+ * @brief Free FlatAst and any arrays it owns.
+ *
+ * @param ast FlatAst instance.
+ */
+void FlatAst_free(FlatAst *ast);
+
+/**
+ * @brief Get the type of a node.
+ */
+static inline enum NodeType FlatAst_type(const FlatAst *ast, FlatIdx idx) {
+	return (enum NodeType) ast->types[idx];
+}
+
+/**
+ * @brief Get the interned value of a node or NULL if it has none.
+ */
+static inline char *FlatAst_value(const FlatAst *ast, FlatIdx idx) {
+	return ast->values[idx] == FLAT_NONE ? NULL : ast->strs[ast->values[idx]];
+}
+
+/**
+ * @brief Determine whether a node type is an arithmetic operator.
+ */
+static inline int FlatAst_is_binop(enum NodeType type) {
+	return type >= E_ADD_NODE && type <= E_MINUS_NODE;
+}
+
+/**
+ * @brief Determine whether a node type is a comparison operator.
+ */
+static inline int FlatAst_is_compare(enum NodeType type) {
+	return type >= E_EEQUAL_NODE && type <= E_BETWEEN_NODE;
+}
+
+#endif
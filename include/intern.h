@@ -0,0 +1,127 @@
+/**
+ * @file intern.h
+ * @author Sayed Sadeed
+ * @brief String interning pool shared by the tokenizer, symbol table and AST.
+ * 
+ * Every distinct string is stored exactly once inside an Arena and given a stable
+ * id. Interned strings never move, so two interned strings are equal if and only if
+ * their pointers (or ids) are equal.
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include "arena.h"
+
+#define INIT_INTERN_SIZE 256
+
+// Id returned when a string could not be interned.
+#define INTERN_ERROR_ID ((unsigned int) -1)
+
+/**
+ * @brief Slot of the InternPool hash table.
+ * 
+ * Hash is kept next to the id so probing rarely has to touch the string itself.
+ */
+typedef struct {
+	unsigned int hash;
+	unsigned int id;
+} InternSlot;
+
+/**
+ * @brief Pool of unique strings.
+ * 
+ * strs and lens are indexed by string id. slots is an open addressing
+ * table of id + 1 (0 being an empty slot) keyed by hash.
+ */
+typedef struct {
+	Arena *arena;
+	char **strs;
+	unsigned int *lens;
+	size_t str_ctr;
+	size_t str_cap;
+	InternSlot *slots;
+	size_t slot_cap;
+} InternPool;
+
+/**
+ * @brief Create malloc'ed InternPool instance.
+ * 
+ * @return New instance of InternPool.
+ */
+InternPool *InternPool_new(void);
+
+/**
+ * @brief Free the pool along with every string it holds.
+ * 
+ * @param pool InternPool instance.
+ */
+void InternPool_free(InternPool *pool);
+
+/**
+ * @brief Intern a string.
+ * 
+ * The string is copied into the pool unless an equal one already exists.
+ * 
+ * @param pool InternPool instance.
+ * @param str Start of string, need not be null terminated.
+ * @param len Length of string.
+ * @return Id of interned string or INTERN_ERROR_ID if failed.
+ */
+unsigned int InternPool_add(InternPool *pool, const char *str, size_t len);
+
+/**
+ * @brief Intern a string without copying it.
+ * 
+ * Like InternPool_add() except the pool references str directly when it is new.
+ * str must be null terminated at len and outlive the pool, i.e a mapped file.
+ * 
+ * @param pool InternPool instance.
+ * @param str Null terminated string.
+ * @param len Length of string.
+ * @return Id of interned string or INTERN_ERROR_ID if failed.
+ */
+unsigned int InternPool_add_static(InternPool *pool, const char *str, size_t len);
+
+/**
+ * @brief Intern a string and return the interned copy.
+ * 
+ * @param pool InternPool instance.
+ * @param str Start of string, need not be null terminated.
+ * @param len Length of string.
+ * @return Pointer to null terminated interned string or NULL if failed.
+ */
+char *InternPool_intern(InternPool *pool, const char *str, size_t len);
+
+/**
+ * @brief Find an interned string without adding it.
+ * 
+ * @param pool InternPool instance.
+ * @param str Start of string, need not be null terminated.
+ * @param len Length of string.
+ * @return Pointer to interned string or NULL if it was never interned.
+ */
+char *InternPool_lookup(InternPool *pool, const char *str, size_t len);
+
+/**
+ * @brief Find the id of a string.
+ * 
+ * @param pool InternPool instance.
+ * @param str Start of string, need not be null terminated.
+ * @param len Length of string.
+ * @param id Set to id of string if found.
+ * @return 0 if found otherwise -1.
+ */
+int InternPool_find(InternPool *pool, const char *str, size_t len, unsigned int *id);
+
+/**
+ * @brief Get an interned string by id.
+ * 
+ * @param pool InternPool instance.
+ * @param id Id returned by InternPool_add().
+ * @return Pointer to null terminated interned string.
+ */
+char *InternPool_get(InternPool *pool, unsigned int id);
+
+#endif
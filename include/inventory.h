@@ -0,0 +1,63 @@
+/**
+ * @file inventory.h
+ * @author Sayed Sadeed
+ * @brief List of hosts groups are run against.
+ *
+ * An inventory file holds one host per line. Surrounding whitespace is ignored
+ * as are blank lines and lines starting with '#'.
+ *
+ * @code
+ * # web tier
+ * web-01.example.com
+ * web-02.example.com
+ * @endcode
+ */
+
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include <stddef.h>
+
+/**
+ * @brief Hosts in the order they were added.
+ */
+typedef struct {
+	char **hosts;
+	size_t host_ctr;
+	size_t host_cap;
+} Inventory;
+
+/**
+ * @brief Create malloc'ed empty Inventory instance.
+ *
+ * @return New instance of Inventory or NULL if failed.
+ */
+Inventory *Inventory_new(void);
+
+/**
+ * @brief Add a host.
+ *
+ * @param inv Inventory instance.
+ * @param host Name of host, the first len chars are copied.
+ * @param len Length of host.
+ * @return 0 if successful otherwise -1.
+ */
+int Inventory_add(Inventory *inv, const char *host, size_t len);
+
+/**
+ * @brief Add every host of an inventory file.
+ *
+ * @param inv Inventory instance.
+ * @param path Path of inventory file, "-" for stdin.
+ * @return Number of hosts added or -1 if failed.
+ */
+int Inventory_load(Inventory *inv, const char *path);
+
+/**
+ * @brief Free Inventory instance.
+ *
+ * @param inv Inventory instance.
+ */
+void Inventory_free(Inventory *inv);
+
+#endif
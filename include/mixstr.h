@@ -0,0 +1,67 @@
+/**
+ * @file mixstr.h
+ * @author Sayed Sadeed
+ * @brief Mixed strings compiled into templates of literal and variable segments.
+ *
+ * A mixed string such as `hi $name` is split once into the literal slices between
+ * its variables and the SyTable slots those variables resolve to. Expanding it is
+ * then a single pass appending segments, see Nexec_mixed_string(), instead of
+ * searching the string and looking up every variable by name on each evaluation.
+ */
+
+#ifndef MIXSTR_H
+#define MIXSTR_H
+
+#include <stddef.h>
+#include "sytable.h"
+
+#define MIXSTR_NONE 0xffffffffu
+
+/**
+ * @brief Segment of a mixed string.
+ *
+ * Literal segments have no name and are the slice of src at offset. Variable
+ * segments cover the variable including its '$', so they can be emitted as is
+ * when undefined, name being the interned variable name without the '$' and slot
+ * its SyTable slot or MIXSTR_NONE if never declared.
+ */
+typedef struct {
+	unsigned int offset;
+	unsigned int length;
+	unsigned int slot;
+	char *name;
+} MixSeg;
+
+/**
+ * @brief Compiled mixed string.
+ *
+ * src is borrowed, lit_len being the combined length of the literal segments.
+ */
+typedef struct {
+	char *src;
+	MixSeg *segs;
+	size_t seg_ctr;
+	size_t var_ctr;
+	size_t lit_len;
+} MixStr;
+
+/**
+ * @brief Compile a mixed string.
+ *
+ * Variables are resolved against the symbols declared so far, so this has to
+ * be done once parsing is done.
+ *
+ * @param mstr Mixed string, must outlive the MixStr.
+ * @param sy_table SyTable to resolve variables with, names are interned in its pool.
+ * @return New instance of MixStr or NULL if failed.
+ */
+MixStr *MixStr_compile(char *mstr, SyTable *sy_table);
+
+/**
+ * @brief Free MixStr instance.
+ *
+ * @param mstr MixStr instance.
+ */
+void MixStr_free(MixStr *mstr);
+
+#endif
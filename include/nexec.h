@@ -4,20 +4,44 @@
  * @brief The execution module implementation. This module described how each node in an AST is executed.
  */
 
+#ifndef NEXEC_H
+#define NEXEC_H
+
 #include "sytable.h"
-#include "node.h"
+#include "flatast.h"
 #include "errors.h"
 #include "vstring.h"
+#include "mixstr.h"
+#include "transport.h"
+#include "inventory.h"
+#include "taskpool.h"
 
 /**
  * @brief Maintain state between tree executions.
+ * 
+ * Trees are executed from their FlatAst encoding, curr being the root
+ * currently executed. mixstrs holds the compiled mixed strings of the FlatAst
+ * indexed like its strs, NULL for strings no mixed string node refers to.
+ * Groups are run through transport, they are skipped while it is NULL. With an
+ * inventory they run on each of its hosts, forks at a time, otherwise on this machine.
+ * Commands running longer than timeout_ms are killed, 0 meaning no limit.
+ * pool holds the workers groups run on threads use, NULL until the first needs it.
+ * A forked NexecMgr, see Nexec_fork(), borrows everything but buff and err_handle.
  */
 typedef struct {
 	SyTable *sy_table;
 	Error *err_handle;
-	NodeMgr *node_mgr;
-	Node *curr_node;
+	FlatAst *ast;
+	FlatIdx curr;
 	VString buff;
+	MixStr **mixstrs;
+	size_t mixstr_ctr;
+	Transport *transport;
+	Inventory *inventory;
+	size_t forks;
+	unsigned int timeout_ms;
+	TaskPool *pool;
+	int forked;
 	unsigned int scope;
 } NexecMgr;
 
@@ -28,6 +52,17 @@ typedef struct {
  */
 NexecMgr *NexecMgr_new(void);
 
+/**
+ * @brief Copy a NexecMgr for running on another thread.
+ * 
+ * The copy shares the FlatAst, SyTable and compiled mixed strings, which it
+ * must only read, and has its own buffer and Error. Free it before nexec_mgr.
+ * 
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @return Pointer to new NexecMgr or NULL.
+ */
+NexecMgr *Nexec_fork(NexecMgr *nexec_mgr);
+
 /**
  * @brief Free instance of NexecMgr;
  * 
@@ -62,8 +97,9 @@ int Nexec_expr_node(NexecMgr *nexec_mgr);
 /**
  * @brief Execute a group node.
  * 
- * Evaluate the commands within a group and perform
- * the appropriate actions.
+ * Run the commands of the current group, see Executor_run_hosts(), and write
+ * their output to stdout and stderr once done. With an inventory the group runs on
+ * every host, see Executor_run_group(), output being written host by host.
  * 
  * @param nexec_mgr Pointer to NexecMgr instance.
  * @return 0 if success otherwise returns -1.
@@ -74,14 +110,14 @@ int Nexec_group_node(NexecMgr *nexec_mgr);
  * @brief Constructor for NexecMgr.
  * 
  * Create a new instance of NexecMgr and assign required 
- * structures.
+ * structures. Every mixed string of ast is compiled, see MixStr_compile().
  * 
  * @param sy_table instance of SyTable.
- * @param node_mgr instance of NodeMgr.
+ * @param ast instance of FlatAst, see FlatAst_lower().
  * @param err_handle instance of Error.
  * @return instance of NexecMgr.
  */
-NexecMgr *Nexec_init(SyTable *sy_table, NodeMgr *node_mgr, Error *err_handle);
+NexecMgr *Nexec_init(SyTable *sy_table, FlatAst *ast, Error *err_handle);
 
 /**
  * @brief Provides the ability to execute individual nodes independant
@@ -89,9 +125,12 @@ NexecMgr *Nexec_init(SyTable *sy_table, NodeMgr *node_mgr, Error *err_handle);
  * 
  * This function is useful for incremental executions such as CLI where
  * execution is performed on a predefined state such as pressing enter on CLI.
- *  
+ * 
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @param node Index of root node inside the FlatAst, i.e ast->roots[n].
+ * @return 0 if success otherwise returns -1.
  */
-int Nexec_exec(NexecMgr *nexec_mgr, Node *node);
+int Nexec_exec(NexecMgr *nexec_mgr, FlatIdx node);
 
 /**
  * @brief Add a custom error string to the list of errors stored in Error.
@@ -101,3 +140,29 @@ int Nexec_exec(NexecMgr *nexec_mgr, Node *node);
  * @param hint additional information pertaining to error.
  */
 void NexecMgr_add_error(Error *err_handle, char *offender, char *hint);
+
+/**
+ * @brief Expand the variables of a mixed string.
+ * 
+ * Undefined variables are reported as errors hinting at the current root and
+ * left unexpanded.
+ * 
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @param str Index of the mixed string inside the FlatAst strs, i.e a node value.
+ * @return Expanded string, held in nexec_mgr->buff unless there was nothing to expand.
+ */
+char *Nexec_mixed_string(NexecMgr *nexec_mgr, unsigned int str);
+
+/**
+ * @brief Build the value of an array literal.
+ * 
+ * Integer items become integers and string items borrow their interned
+ * strings, nested arrays are built recursively.
+ * 
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @param node Index of array node inside the FlatAst.
+ * @return Owned array value or undefined if failed.
+ */
+Value Nexec_array(NexecMgr *nexec_mgr, FlatIdx node);
+
+#endif
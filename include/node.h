@@ -9,6 +9,7 @@
 
 #include <string.h>
 #include "sytable.h"
+#include "arena.h"
 
 enum NodeType {
 	E_ADD_NODE, 
@@ -37,11 +38,12 @@ enum NodeType {
  * @brief Node correlates to a node within a tree.
  * 
  * This is used to map tokens to an AST.
- * its centre/root.
+ * its centre/root. Function nodes carry the KeywordId of the function called.
  */
 struct Node {
     union SyntaxNode *data;
     enum NodeType type;
+	KeywordId kwid;
 	unsigned int depth;
 	char *value;
 };
@@ -79,30 +81,41 @@ union SyntaxNode {
  * 
  * This provides a high level interfacing for the syntax tree. It is preferred to use this
  * for anything node related as it manages internal memory allocs and deallocs.
- * 
+ * Every node, its data and array items are allocated from arena so the whole
+ * tree is released at once, nodes are never freed individually.
  */
 typedef struct {
     Node **nodes; 
     size_t nodes_ctr;
     size_t nodes_cap;
+    Arena *arena;
 } NodeMgr;
 
 /**
- * @brief Create new node instance.
+ * @brief Create new node instance owned by NodeMgr.
  * 
- * Will create a new node instance irrespective of NodeMgr.
+ * The node and its data are carved out of a single arena allocation.
  * 
- * @param wdata With Data flag determines whether to malloc the data *.
+ * @param node_mgr NodeMgr instance.
+ * @param wdata With Data flag determines whether to allocate the data *.
  * @return Pointer to newly created node or null ptr if something went wrong.
  */
-Node *Node_new(int wdata);
+Node *NodeMgr_new_node(NodeMgr *node_mgr, int wdata);
+
+/**
+ * @brief Allocate memory which lives as long as the nodes, i.e array items.
+ * 
+ * @param node_mgr NodeMgr instance.
+ * @param size Number of bytes.
+ * @return Pointer to uninitialised memory or NULL if failed.
+ */
+void *NodeMgr_alloc(NodeMgr *node_mgr, size_t size);
 
 /**
  * @brief Add an existing Node to the internal NodeMgr store.
  * 
- * This will allow the addition of externally created Node into the NodeMgr. 
- * Please note that it is expected *node will be a pointer to Node created on heap. To avoid unexpected 
- * behavior it is recommended to use Node_new() then add the returned pointer using this function.
+ * Adds a node as the root of a tree. The node should have been created
+ * by NodeMgr_new_node() on the same NodeMgr.
  * 
  * @param node_mgr NodeMgr instance.
  * @param node Node instance to be added.
@@ -112,6 +125,13 @@ Node *Node_new(int wdata);
 
  Node *NodeMgr_find_node(NodeMgr *node_mgr, char *value);
 
+/**
+ * @brief Release every node, keeping node manager for reuse.
+ *
+ * @param node_mgr Pointer to the NodeMgr instance.
+ */
+void NodeMgr_reset(NodeMgr *node_mgr);
+
 /**
  * @brief Free all resources creates by node manager. Including node manager itself.
  *
@@ -140,6 +160,14 @@ NodeMgr *NodeMgr_new(void);
  */
 Node **grow_nodes(NodeMgr *node_mgr);
 
+/**
+ * @brief Print every tree in NodeMgr, one node per line indented by depth.
+ * 
+ * @param node_mgr Instance of NodeMgr.
+ * @param title Shown in the dump header, i.e "parsed".
+ */
+void NodeMgr_print_trees(NodeMgr *node_mgr, const char *title);
+
 /**
  * @brief Determine whether a node is of type comaprison operator.
  * 
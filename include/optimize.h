@@ -0,0 +1,34 @@
+/**
+ * @file optimize.h
+ * @author Sayed Sadeed
+ * @brief Optimization pass run over parsed trees before they are lowered.
+ *
+ * Constant subtrees, arithmetic and comparisons over integer and string literals,
+ * are folded into a single integer node. Mixed strings without any variable are
+ * turned into plain strings. Identities, x + 0, 0 + x, x - 0, x * 1, 1 * x and
+ * x / 1, are reduced to x wherever doing so can't change how x is evaluated.
+ *
+ * Only rewrites which leave the output of a script unchanged are made. Folding
+ * uses the 64 bit wrapping arithmetic of the executors, see VALUE_WRAP() and
+ * Value_div(). A constant whose value is negative is left unfolded since integer
+ * literals are unsigned.
+ */
+
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include "node.h"
+#include "intern.h"
+
+/**
+ * @brief Fold and simplify every tree in NodeMgr in place.
+ *
+ * Should only be run on trees which parsed without errors.
+ *
+ * @param node_mgr NodeMgr holding the parsed trees.
+ * @param pool InternPool values of folded nodes are interned into.
+ * @return Number of rewrites made or -1 if failed.
+ */
+int Optimize_ast(NodeMgr *node_mgr, InternPool *pool);
+
+#endif
@@ -45,11 +45,11 @@ int ParserMgr_free(ParserMgr *par_mgr);
 /**
  * @brief Add a error string to the list of errors stored in Error.
  * 
- * @param err_error Instance of Error.
+ * @param par_mgr Instance of ParserMgr, its Error instance receives the error.
  * @param offender Token which triggered the error.
  * @param err_type Index of error string in the array of errors in parser.c.
  */
-void ParserMgr_add_error(Error *err_handle, Token *offender, int err_type);
+void ParserMgr_add_error(ParserMgr *par_mgr, Token *offender, int err_type);
 
 /**
  * @brief Will consume a group based on grammar defintion.
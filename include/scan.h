@@ -0,0 +1,59 @@
+/**
+ * @file scan.h
+ * @author Sayed Sadeed
+ * @brief Vectorized scanning primitives used by the tokenizer.
+ * 
+ * Scanners jump over long runs of bytes which can't end a lexeme such as string contents,
+ * comments and whitespace. An SSE2 or AVX2 implementation is selected at runtime
+ * depending on what the cpu supports, with a scalar fallback for everything else.
+ * 
+ * Scanners never read at or past len, which is usually the null terminator of buff but
+ * may also be the end of a chunk inside it, see TokenMgr_build_tokens_parallel().
+ */
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stddef.h>
+
+/**
+ * @brief Find the end of a string literal or comment.
+ * 
+ * @param buff Null terminated buffer.
+ * @param len Length of buff.
+ * @param idx Index to start scanning from.
+ * @param delim Delimiter which closes the lexeme.
+ * @return Index of first delim, NEWLINE or null terminator at or after idx, or len.
+ */
+size_t scan_until(const char *buff, size_t len, size_t idx, char delim);
+
+/**
+ * @brief Skip a run of whitespace including newlines.
+ * 
+ * Newlines are counted during the same pass so line numbers stay correct.
+ * 
+ * @param buff Null terminated buffer.
+ * @param len Length of buff.
+ * @param idx Index to start scanning from.
+ * @param lines Incremented by the number of newlines skipped.
+ * @return Index of first non whitespace character at or after idx, or len.
+ */
+size_t scan_space(const char *buff, size_t len, size_t idx, int *lines);
+
+/**
+ * @brief Select scanner implementation.
+ * 
+ * By default the widest implementation supported by the cpu is used. This is 
+ * mostly useful for benchmarks and for ruling out the vector paths when debugging.
+ * 
+ * @param name One of "scalar", "sse2", "avx2" or NULL for automatic detection.
+ * @return 0 if selected otherwise -1 when not supported on this machine.
+ */
+int scan_select(const char *name);
+
+/**
+ * @brief Name of the scanner implementation currently in use.
+ */
+const char *scan_name(void);
+
+#endif
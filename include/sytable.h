@@ -11,6 +11,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include "tokenizer.h"
+#include "intern.h"
+#include "value.h"
+
+#define INIT_SYINDEX_SIZE 16
 
 enum SyType {
 	E_GROUP_TYPE, E_INTEGER_TYPE, E_IDN_TYPE, E_STRING_TYPE, E_FUNC_TYPE
@@ -18,36 +22,60 @@ enum SyType {
 
 /**
  * @brief Store relevant token pertaining to symbol entry.
+ * 
+ * label is interned, see SyTable_find_symbol(). val is owned by the symbol.
  */
 typedef struct {
 	char *label;
-	char *val;
+	Value val;
 	unsigned int lineno;
 	enum SyType sy_type;
 } Symbol;
 
+/**
+ * @brief Entry of the SyTable index.
+ * 
+ * Hash of the label is kept next to the slot so probing rarely touches the symbol.
+ */
+typedef struct {
+	unsigned int hash;
+	unsigned int slot;
+} SyIndexEntry;
+
 /**
  * @brief SymbolTable which stores collection of symbols.
+ * 
+ * symbols is dense and in the order symbols were added, see SyTable_get_slot().
+ * index is a Robin Hood open addressing table of slot + 1 (0 being empty) keyed
+ * by the hash of the label, entries are kept ordered by distance from their home
+ * bucket so a miss ends as soon as a closer entry is met.
  */
 typedef struct {
 	Symbol **symbols;
 	size_t sym_cap;
 	size_t sym_ctr;
+	SyIndexEntry *index;
+	size_t index_cap;
+	InternPool *pool;
 } SyTable;
 
 /**
  * @brief Create malloc'ed SyTable instance.
  * 
+ * @param pool InternPool used for symbol labels.
  * @return New instance of SyTable.
  */
-SyTable *SyTable_new();
+SyTable *SyTable_new(InternPool *pool);
 
 /**
  * @brief Add a symbol to SyTable instance.
  * 
+ * Adding a label which already exists gives it a new slot, lookups keep finding
+ * the first symbol.
+ * 
  * @param sy_table Instance of SyTable.
  * @param label Name of the symbol.
- * @param val Value stored.
+ * @param val Initial string value, copied, or NULL if undefined.
  * @param lineno line number where symbol occurs in source map.
  * @param sy_type Enum to specify symbol type.
  * @return 0 if success or 1 if error.
@@ -86,6 +114,18 @@ Symbol *Symbol_new(void);
  */
 Symbol *SyTable_get_symbol(SyTable *sy_table, char *sy_name);
 
+/**
+ * @brief Get an existing symbol by its interned label.
+ * 
+ * Same as SyTable_get_symbol() but sy_name must come from the table's InternPool
+ * (i.e a token or node value), which allows comparing labels by pointer only.
+ * 
+ * @param sy_table SyTable instance.
+ * @param sy_name interned name of the symbol to return.
+ * @return NULL if symbol can't be found otherwise return pointer to matched symbol.
+ */
+Symbol *SyTable_find_symbol(SyTable *sy_table, char *sy_name);
+
 /**
  * @brief Update the value stored inside a symbol
  *
@@ -95,6 +135,41 @@ Symbol *SyTable_get_symbol(SyTable *sy_table, char *sy_name);
  */
 int SyTable_update_symbol(SyTable *sy_table, char *sy_name, char *sy_n_value);
 
+/**
+ * @brief Get a symbol by its slot.
+ * 
+ * Symbols are never removed or reordered, so the index a symbol was added at
+ * is its slot for the lifetime of the table.
+ * 
+ * @param sy_table SyTable instance.
+ * @param slot Slot of the symbol, i.e resolved by FlatAst_lower().
+ * @return NULL if slot is out of range otherwise pointer to the symbol.
+ */
+Symbol *SyTable_get_slot(SyTable *sy_table, unsigned int slot);
+
+/**
+ * @brief Find the slot of a symbol by name.
+ * 
+ * @param sy_table SyTable instance.
+ * @param sy_name name of the symbol.
+ * @param slot Set to slot of the symbol if found.
+ * @return 0 if found otherwise -1.
+ */
+int SyTable_lookup_slot(SyTable *sy_table, char *sy_name, unsigned int *slot);
+
+/**
+ * @brief Update the value stored inside a symbol by its slot.
+ * 
+ * The symbol takes ownership of val, freeing its previous value. If the
+ * slot doesn't exist val is freed instead.
+ * 
+ * @param sy_table SyTable instance.
+ * @param slot Slot of the symbol.
+ * @param val New value.
+ * @return 0 if successfully updated otherwise -1.
+ */
+int SyTable_update_slot(SyTable *sy_table, unsigned int slot, Value val);
+
 /**
  * @brief Perform relloc on array of of symbols in SyTable.
  * 
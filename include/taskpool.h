@@ -0,0 +1,101 @@
+/**
+ * @file taskpool.h
+ * @author Sayed Sadeed
+ * @brief Work stealing pool of threads running submitted tasks.
+ *
+ * Every worker owns a deque. Submitted tasks are dealt out to the deques in turn,
+ * a worker takes from the back of its own and, once it runs dry, steals from the
+ * front of the others. Each deque has its own lock, held only to move a task in or
+ * out, so there is no queue every worker contends on and a worker stuck on a slow
+ * task leaves the rest of its deque to whoever is idle. Workers with nothing left
+ * to run or steal sleep until more is submitted.
+ */
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/**
+ * @brief Function run by a task, worker being the index of the worker running it.
+ */
+typedef void (*TaskFn)(void *arg, size_t worker);
+
+/**
+ * @brief Counters of a worker, or summed over all workers.
+ *
+ * run is the number of tasks run, stolen how many of those were taken from another
+ * worker's deque and steal_fails the number of deques found empty while looking for
+ * one to steal.
+ */
+typedef struct {
+	size_t run;
+	size_t stolen;
+	size_t steal_fails;
+} TaskPoolStats;
+
+typedef struct TaskPool TaskPool;
+
+/**
+ * @brief Create malloc'ed TaskPool instance and start its workers.
+ *
+ * Workers which fail to start are left out, the pool is only given up on if none do.
+ *
+ * @param workers Number of worker threads.
+ * @return New instance of TaskPool or NULL if failed.
+ */
+TaskPool *TaskPool_new(size_t workers);
+
+/**
+ * @brief Queue a task to run on one of the workers.
+ *
+ * @param pool TaskPool instance.
+ * @param fn Function to run.
+ * @param arg Argument of fn.
+ * @return 0 if successful otherwise -1.
+ */
+int TaskPool_submit(TaskPool *pool, TaskFn fn, void *arg);
+
+/**
+ * @brief Wait until every task submitted so far has run.
+ *
+ * @param pool TaskPool instance.
+ */
+void TaskPool_wait(TaskPool *pool);
+
+/**
+ * @brief Number of workers running.
+ *
+ * @param pool TaskPool instance.
+ * @return Number of workers, 0 if pool is NULL.
+ */
+size_t TaskPool_workers(TaskPool *pool);
+
+/**
+ * @brief Get the counters of the pool.
+ *
+ * Only exact while no tasks are running, see TaskPool_wait().
+ *
+ * @param pool TaskPool instance.
+ * @param total Set to the counters summed over every worker.
+ * @param per_worker Array of TaskPool_workers() counters to fill in, may be NULL.
+ */
+void TaskPool_stats(TaskPool *pool, TaskPoolStats *total, TaskPoolStats *per_worker);
+
+/**
+ * @brief Print the counters of the pool, summed then worker by worker.
+ *
+ * @param pool TaskPool instance, NULL if none was started.
+ * @param out Stream to print to.
+ */
+void TaskPool_print_stats(TaskPool *pool, FILE *out);
+
+/**
+ * @brief Stop the workers once every submitted task has run and free the pool.
+ *
+ * @param pool TaskPool instance.
+ */
+void TaskPool_free(TaskPool *pool);
+
+#endif
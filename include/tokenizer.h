@@ -9,16 +9,23 @@
 
 #include <string.h>
 #include "tokens.h"
+#include "intern.h"
 #include "conf.h"
 
 /**
  * @brief Represent a single token read from input.
  *
- * Struct will hold every identified token meta data. Is needed for parsing.
+ * Tokens don't own their text. They are plain records which locate the
+ * lexeme inside the source buffer held by TokenMgr, along with the id of the value 
+ * inside the InternPool, see TokenMgr_token_value(). Keyword tokens are identified 
+ * once while lexing and carry their KeywordId.
  */
 typedef struct {
 	TokenType type;
-	char *value;
+	KeywordId kwid;
+	unsigned int offset;
+	unsigned int length;
+	unsigned int sid;
 	int lineno;
 } Token;
 
@@ -27,27 +34,30 @@ typedef struct {
  *
  * This provides a high level interfacing for token management. It is preferred to use this
  * for anything token related as it manages internal memory allocs and deallocs.
- * Struct will mantain all tokens and responsible for methods.
+ * All tokens live in a single contiguous array and reference the source buffer by offset.
+ * Token values are interned into pool which is shared with the symbol table and AST.
  */
 typedef struct {
-	Token *toks_head;
-	Token **toks_curr;
-	Token *toks_tail;
+	const char *src;
+	size_t src_len;
+	Token *toks;
+	Token *toks_curr;
 	size_t tok_ctr;
 	size_t tok_cap;
+	InternPool *pool;
 } TokenMgr;
 
 
 /**
- * @brief Perform relloc on array of of tokens.
+ * @brief Perform relloc on array of tokens.
  * 
  * This is an internal function used to allocate more space
- * for storage of tokens.
+ * for storage of tokens. The current token pointer is rebased onto the new array.
  * 
  * @param tok_mgr TokenMgr instance which being applied to.
- * @return Newly allocated Token**.
+ * @return Newly allocated Token* or NULL if failed.
  */
-Token **grow_curr_tokens(TokenMgr *tok_mgr);
+Token *grow_tokens(TokenMgr *tok_mgr);
 
 /**
  * @brief Build tokens from steam of input.
@@ -55,33 +65,69 @@ Token **grow_curr_tokens(TokenMgr *tok_mgr);
  * Provides a decoupled implementation for building tokens from
  * any source stream. Can be contents of file or stdin.
  * 
+ * Tokenizing is done in place, buff is never modified and is still owned 
+ * by the caller. Values of tokens are interned so they remain valid even once
+ * buff is released.
+ * 
  * @param buff the contents which should be tokenized.
  * @param tokmgr Token Manager to handle tokenization.
  * @return int signifying status.
  */
-int TokenMgr_build_tokens(char *buff, TokenMgr *tokmgr);
+int TokenMgr_build_tokens(const char *buff, TokenMgr *tokmgr);
+
+/**
+ * @brief Build tokens from a large buffer using several threads.
+ * 
+ * The buffer is split into chunks at newlines which are tokenized on a pool of threads,
+ * each into its own TokenMgr and InternPool. Chunks are then stitched together in order,
+ * remapping interned ids and line numbers. A chunk is only kept when the previous one
+ * ended outside of a brace group, otherwise it is tokenized again serially so the 
+ * resulting tokens are always the same as TokenMgr_build_tokens(). Small buffers 
+ * are tokenized serially.
+ * 
+ * @param buff the contents which should be tokenized.
+ * @param tokmgr Token Manager to handle tokenization.
+ * @param workers Number of threads including the caller, 0 for one per online core.
+ * @return int signifying status.
+ */
+int TokenMgr_build_tokens_parallel(const char *buff, TokenMgr *tokmgr, unsigned int workers);
 
 /**
  * @brief Create token manager malloc'ed.
  * 
  * This function acts as a constructor for the Token manager.
  * 
+ * @param pool InternPool which receives token values.
  * @return newly created TokenMgr pointer.
  */
-TokenMgr *TokenMgr_new(void);
+TokenMgr *TokenMgr_new(InternPool *pool);
 
 /**
  * @brief Add another token to token manager.
  * 
- * Important to note that the tok_val is expected to be null terminated string ptr.
+ * The token is appended to the contiguous token array, no allocation is 
+ * made unless the array has to grow. Values of non literal tokens are interned.
  * 
  * @param tok_mgr Pointer to token manager.
  * @param tok_type Type of token.
- * @param tok_value Value of token.
+ * @param tok_offset Offset of the lexeme inside source buffer.
+ * @param tok_length Length of the lexeme.
  * @param tok_lineno Line number in source file where token occurs.
  * @return int signifying status.
  */
-int TokenMgr_add_token(TokenMgr *tok_mgr, TokenType tok_type, char *tok_val, int tok_lineno);
+int TokenMgr_add_token(TokenMgr *tok_mgr, TokenType tok_type, size_t tok_offset, size_t tok_length, int tok_lineno);
+
+/**
+ * @brief Get the null terminated value of a token.
+ * 
+ * Fixed literals (operators, brackets etc) resolve to a static string while
+ * all other tokens resolve to their interned string.
+ * 
+ * @param tok_mgr Pointer to token manager.
+ * @param tok Token stored by tok_mgr.
+ * @return Pointer to token value.
+ */
+char *TokenMgr_token_value(TokenMgr *tok_mgr, Token *tok);
 
 /**
  * @brief Free tokens stored by token manager as well as token manager.
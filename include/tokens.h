@@ -7,6 +7,8 @@
 #ifndef TOKENS_H
 #define TOKENS_H
 
+#include <stddef.h>
+
 // Below are language literalls.
 #define COMMENT '#'
 #define NEWLINE '\n'
@@ -30,7 +32,71 @@
 #define DOT '.'
 #define BTICK '`'
 
-#define KWORDS_SIZE 7
+/**
+ * @brief Identifier of a keyword or builtin, see keywords.def.
+ * 
+ * E_KW_NONE is given to words which aren't keywords e.g group names.
+ */
+typedef enum {
+	E_KW_NONE,
+#define KEYWORD(id, str) id,
+#include "keywords.def"
+#undef KEYWORD
+	E_KW_COUNT
+} KeywordId;
+
+#define KWORDS_SIZE (E_KW_COUNT - 1)
+
+/**
+ * @brief Character classes used by the tokenizer to dispatch on the first character of a lexeme.
+ */
+typedef enum {
+	E_CC_OTHER,
+	E_CC_NUL,
+	E_CC_SPACE,
+	E_CC_NEWLINE,
+	E_CC_COMMENT,
+	E_CC_ALPHA,
+	E_CC_DIGIT,
+	E_CC_SINGLE,
+	E_CC_LBRACE,
+	E_CC_RBRACE,
+	E_CC_BTICK,
+	E_CC_DQUOTE,
+	E_CC_VAR,
+	E_CC_BANG,
+	E_CC_LESSTHAN,
+	E_CC_GREATERTHAN,
+	E_CC_EQUAL
+} CharClass;
+
+/**
+ * Character property flags stored in Char_flags.
+ * 
+ * CF_SPACE whitespace (excluding NEWLINE).
+ * CF_DIGIT decimal digit.
+ * CF_ALPHA ascii letter.
+ * CF_IDENT character allowed within an identifier.
+ */
+#define CF_SPACE 0x01
+#define CF_DIGIT 0x02
+#define CF_ALPHA 0x04
+#define CF_IDENT 0x08
+
+/**
+ * Lookup tables indexed by an unsigned char. These are built at compile time 
+ * from the literals above so are independent of the current locale. 
+ * 
+ * Char_class the CharClass of a character.
+ * Char_flags combination of CF_* flags for a character.
+ * Char_token TokenType of single character literals (E_CC_SINGLE).
+ */
+extern const unsigned char Char_class[256];
+extern const unsigned char Char_flags[256];
+extern const unsigned char Char_token[256];
+
+#define char_class(c) (Char_class[(unsigned char) (c)])
+#define char_is(c, flag) (Char_flags[(unsigned char) (c)] & (flag))
 
 /**
  * brief Token type in conjunction to the derived types.
@@ -77,4 +143,53 @@ typedef enum {
  */
 int is_valid_keyword(char *str);
 
+/**
+ * @brief Get the fixed string representation of a token type.
+ * 
+ * Literal tokens such as operators and brackets always have the same value,
+ * so there is no need to read them from source.
+ * 
+ * @param type the token type.
+ * @return Static string of literal or NULL if token value comes from source.
+ */
+char *token_literal(TokenType type);
+
+/**
+ * @brief Hash used to index keywords.
+ * 
+ * Shared between keyword_lookup() and the generator tools/kwgen.c which searches
+ * for a seed giving a minimal perfect hash over keywords.def.
+ * 
+ * @param seed Seed found by generator.
+ * @param str Start of word, need not be null terminated.
+ * @param len Length of word.
+ * @return hash value.
+ */
+static inline unsigned int kw_hash(unsigned int seed, const char *str, size_t len) {
+	unsigned int h = seed ^ (unsigned int) len;
+	for (size_t i = 0; i < len; i++) {
+		h = (h ^ (unsigned char) str[i]) * 16777619u;
+	}
+	return h;
+}
+
+/**
+ * @brief Identify a keyword.
+ * 
+ * Costs a single hash and a single compare.
+ * 
+ * @param str Start of word, need not be null terminated.
+ * @param len Length of word.
+ * @return KeywordId of word or E_KW_NONE if not a keyword.
+ */
+KeywordId keyword_lookup(const char *str, size_t len);
+
+/**
+ * @brief Get spelling of a keyword.
+ * 
+ * @param id KeywordId.
+ * @return keyword string or NULL for E_KW_NONE.
+ */
+const char *keyword_name(KeywordId id);
+
 #endif
@@ -0,0 +1,158 @@
+/**
+ * @file transport.h
+ * @author Sayed Sadeed
+ * @brief Pluggable transport running the commands of a group on a host.
+ *
+ * A Transport is a table of backend functions. A session is opened per host, commands
+ * are run through it one at a time and it is closed once the group is done. Output
+ * is captured into the ropes of a TransportResult as it arrives, nothing touches the
+ * disk. Backends keep their per session state in TransportSession ctx.
+ *
+ * @code
+ * TransportSession *session = Transport_open(Transport_local(), "localhost");
+ * TransportResult res = TransportResult_new();
+ *
+ * if (session && Transport_run(session, "uptime", &res) == 0 && res.status == 0)
+ *     ...
+ * TransportResult_free(&res);
+ * Transport_close(session);
+ * @endcode
+ */
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <sys/types.h>
+#include "vrope.h"
+
+#define TRANSPORT_LOCALHOST "localhost"
+#define TRANSPORT_TIMEOUT_STATUS 124
+
+/**
+ * @brief Output and exit status of a command.
+ *
+ * status is the exit code of the command, 128 + signal number if it was killed
+ * as shells report it, or -1 if it could not be run.
+ */
+typedef struct {
+	VRope out;
+	VRope err;
+	int status;
+} TransportResult;
+
+/**
+ * @brief Command started without waiting for it, see Transport start.
+ *
+ * out and err are the non blocking read ends of its stdout and stderr, owned
+ * by the caller who also reaps pid. pid leads its own process group, so killing
+ * -pid reaches whatever the command started.
+ */
+typedef struct {
+	pid_t pid;
+	int out;
+	int err;
+} TransportProc;
+
+typedef struct Transport Transport;
+
+/**
+ * @brief Session with a single host.
+ *
+ * timeout_ms is the time a command run through the session may take in milliseconds,
+ * 0 for no limit, set after opening it. A command running past it is killed along
+ * with whatever it started and ends with status TRANSPORT_TIMEOUT_STATUS.
+ */
+typedef struct {
+	Transport *transport;
+	char *host;
+	void *ctx;
+	unsigned int timeout_ms;
+} TransportSession;
+
+/**
+ * @brief Backend functions of a transport.
+ *
+ * open sets up ctx, run executes a command appending its output to res and close
+ * releases ctx. start is optional, it spawns a command and returns at once so an
+ * event loop can drive many of them, see EvLoop_run(). open, run and start return
+ * 0 if successful otherwise -1.
+ */
+struct Transport {
+	const char *name;
+	int (*open)(TransportSession *session);
+	int (*run)(TransportSession *session, const char *cmd, TransportResult *res);
+	void (*close)(TransportSession *session);
+	int (*start)(TransportSession *session, const char *cmd, TransportProc *proc);
+};
+
+/**
+ * @brief Get the local transport.
+ *
+ * Every command is run by a fresh /bin/sh -c spawned with posix_spawn() whatever
+ * the host, standing in for a remote shell. stdin is /dev/null and stdout and stderr
+ * are read through pipes. The name of the host is passed in $VMEL_HOST.
+ *
+ * @return Shared Transport instance.
+ */
+Transport *Transport_local(void);
+
+/**
+ * @brief Get the local session transport.
+ *
+ * Every session keeps a single /bin/sh whose stdin commands are written to, so a
+ * group pays for starting a shell once rather than per command. Each command is
+ * followed by printing a marker unique to the session to stdout, along with the
+ * exit status, and to stderr, output ending at the markers. Commands run through
+ * eval with stdin /dev/null, so shell state such as the working directory carries
+ * over from one command to the next. A command which exits the shell ends with
+ * the shell's status and the next one starts a new shell, as does one killed for
+ * running past the timeout of the session. $VMEL_HOST is set as for Transport_local().
+ *
+ * SIGPIPE is ignored once a session is opened, so a shell dying mid write fails
+ * the command instead of killing the process.
+ *
+ * @return Shared Transport instance.
+ */
+Transport *Transport_local_session(void);
+
+/**
+ * @brief Open a session with a host.
+ *
+ * @param transport Transport instance.
+ * @param host Name of host, copied.
+ * @return New instance of TransportSession or NULL if failed.
+ */
+TransportSession *Transport_open(Transport *transport, const char *host);
+
+/**
+ * @brief Run a command and wait for it to exit.
+ *
+ * @param session TransportSession instance.
+ * @param cmd Shell command.
+ * @param res Result output is appended to and status set in.
+ * @return 0 if the command ran, whatever its status, otherwise -1.
+ */
+int Transport_run(TransportSession *session, const char *cmd, TransportResult *res);
+
+/**
+ * @brief Close a session and free it.
+ *
+ * @param session TransportSession instance.
+ */
+void Transport_close(TransportSession *session);
+
+/**
+ * @brief Instantiate an empty TransportResult.
+ *
+ * @return TransportResult object.
+ */
+TransportResult TransportResult_new(void);
+
+/**
+ * @brief Free the output of a TransportResult, leaving it empty.
+ *
+ * @param res TransportResult instance.
+ */
+void TransportResult_free(TransportResult *res);
+
+#endif
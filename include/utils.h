@@ -16,22 +16,43 @@
 void print_usage(void);
 
 /**
- * @brief Read contents of file to buffer.
+ * @brief Script source loaded into memory.
+ * 
+ * Regular files are memory mapped read only, anything else (pipes, stdin) is read 
+ * into a heap buffer. Either way buff is null terminated and must be treated as
+ * read only, the tokenizer consumes it in place.
+ */
+typedef struct {
+	char *buff;
+	size_t len;
+	size_t map_len;
+} SrcFile;
+
+/**
+ * @brief Load a script for tokenizing.
  *
- * This function will read the contents of a passed source file (*.vml).
- * It will simply dump the contents of a file to a buffer.
- * The buffer is created on heap so must be managed by caller. See below example
+ * This function will map the contents of a passed source file (*.vml) into memory
+ * with a private read only mapping advised for sequential access. No copy of the 
+ * file is made up front. When the source can't be mapped, for instance a pipe or stdin, 
+ * it falls back to reading the stream into a heap buffer. See below example
  *
  * @code
- * char *filename = "~/Desktop/run.vml";
- * char *buffer = file_to_buffer(filename);
- * free(buffer) // when done.
+ * SrcFile *src = SrcFile_open("~/Desktop/run.vml");
+ * TokenMgr_build_tokens(src->buff, tok_mgr);
+ * SrcFile_close(src) // when done with tokens and nodes.
  * @endcode
  *
- * @param filename Path to source file.
- * @return Pointer to buffer containing contents of file.
+ * @param filename Path to source file or "-" for stdin.
+ * @return SrcFile instance or NULL if source could not be read.
  */
-char *file_to_buffer(const char *);
+SrcFile *SrcFile_open(const char *filename);
+
+/**
+ * @brief Release a SrcFile and its buffer.
+ * 
+ * @param src SrcFile instance.
+ */
+void SrcFile_close(SrcFile *src);
 
 /**
  * @brief Convert a string of numbers to integer.
@@ -42,6 +63,17 @@ char *file_to_buffer(const char *);
  */
 int string_to_int(char *str, size_t len);
 
+/**
+ * @brief Convert a string of numbers to a 64 bit integer.
+ * 
+ * Same as string_to_int() but wide enough for runtime values.
+ * 
+ * @param str string to be converted.
+ * @param len the length of the string.
+ * @return converted integer or -1 if str isn't only digits.
+ */
+long long string_to_int64(const char *str, size_t len);
+
 /**
  * @brief Wrapper around sprintf to convert an integer to a string.
  * 
@@ -160,4 +192,27 @@ int null_check(void *obj,char *hint);
  */
 unsigned int string_to_ascii(char *str_rep);
 
+/**
+ * @brief Hash a string using FNV-1a.
+ * 
+ * Unlike string_to_ascii() every byte position contributes to the result, 
+ * so it is suitable for hash tables.
+ * 
+ * @param str Start of string, need not be null terminated.
+ * @param len Length of string.
+ * @return 32 bit hash.
+ */
+unsigned int string_hash(const char *str, size_t len);
+
+/**
+ * @brief Hash a large buffer 8 bytes at a time.
+ * 
+ * Intended for fingerprinting whole scripts rather than hash tables.
+ * 
+ * @param buff Buffer to hash.
+ * @param len Length of buffer.
+ * @return 64 bit hash.
+ */
+unsigned long long buffer_hash64(const void *buff, size_t len);
+
 #endif
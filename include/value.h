@@ -0,0 +1,163 @@
+/**
+ * @file value.h
+ * @author Sayed Sadeed
+ * @brief Tagged runtime values stored in symbols.
+ *
+ * Integers and booleans are held directly, so arithmetic on variables needs no
+ * conversion. Strings are only produced when a value is printed or interpolated,
+ * see Value_to_string(). A string value may borrow its characters, i.e an interned
+ * literal, or own a malloc'ed copy.
+ */
+
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <stddef.h>
+#include "vstring.h"
+
+enum ValueType {
+	E_NONE_VALUE, E_INT_VALUE, E_BOOL_VALUE, E_STR_VALUE, E_ARRAY_VALUE
+};
+
+typedef struct ValueArray ValueArray;
+
+/**
+ * @brief Runtime value, E_NONE_VALUE being undefined.
+ *
+ * text is the literal an integer was assigned from, i.e "007", so printing or
+ * interpolating it gives back what the script wrote. It is borrowed from the
+ * tree and NULL for integers computed at run time.
+ */
+typedef struct {
+	unsigned char type;
+	unsigned char owned;
+	union {
+		long long num;
+		char *str;
+		ValueArray *arr;
+	} as;
+	char *text;
+} Value;
+
+/**
+ * @brief Array of values, always owned by the value holding it.
+ */
+struct ValueArray {
+	size_t len;
+	Value items[];
+};
+
+/**
+ * @brief Undefined value.
+ */
+static inline Value Value_none(void) {
+	return (Value) { E_NONE_VALUE, 0, { 0 }, NULL };
+}
+
+/**
+ * @brief Integer value.
+ */
+static inline Value Value_int(long long num) {
+	return (Value) { E_INT_VALUE, 0, { .num = num }, NULL };
+}
+
+/**
+ * @brief Integer value of a literal, keeping the text it was written as.
+ *
+ * @param num Value of the literal.
+ * @param text Literal as written, borrowed.
+ */
+static inline Value Value_int_literal(long long num, char *text) {
+	return (Value) { E_INT_VALUE, 0, { .num = num }, text };
+}
+
+/**
+ * @brief Boolean value, any non zero num is true.
+ */
+static inline Value Value_bool(long long num) {
+	return (Value) { E_BOOL_VALUE, 0, { .num = num != 0 }, NULL };
+}
+
+/**
+ * @brief String value.
+ *
+ * @param str Null terminated string.
+ * @param owned Set if str was malloc'ed and is to be freed with the value.
+ */
+static inline Value Value_str(char *str, int owned) {
+	return (Value) { E_STR_VALUE, owned != 0, { .str = str }, NULL };
+}
+
+/**
+ * @brief Add, subtract or multiply integers wrapping around on overflow.
+ *
+ * Overflowing a signed integer is undefined, so arithmetic on values goes
+ * through unsigned integers instead.
+ */
+#define VALUE_WRAP(lhs, op, rhs) ((long long) ((unsigned long long) (lhs) op (unsigned long long) (rhs)))
+
+/**
+ * @brief Divide integers without trapping.
+ *
+ * Dividing by zero yields 0 and dividing by -1 negates, wrapping as VALUE_WRAP()
+ * does since INT64_MIN / -1 overflows.
+ *
+ * @param lhs Dividend.
+ * @param rhs Divisor.
+ * @return Quotient.
+ */
+static inline long long Value_div(long long lhs, long long rhs) {
+	if (rhs == 0)
+		return 0;
+	if (rhs == -1)
+		return VALUE_WRAP(0, -, lhs);
+	return lhs / rhs;
+}
+
+/**
+ * @brief Array value of len undefined items.
+ *
+ * @param len Number of items.
+ * @return Array value or undefined if failed.
+ */
+Value Value_array(size_t len);
+
+/**
+ * @brief Copy a value, owned strings and arrays are duplicated.
+ *
+ * @param val Value to copy.
+ * @return Copy of val.
+ */
+Value Value_copy(const Value *val);
+
+/**
+ * @brief Free whatever a value owns and make it undefined.
+ *
+ * @param val Value instance.
+ */
+void Value_free(Value *val);
+
+/**
+ * @brief Integer a value evaluates to inside an expression.
+ *
+ * Strings of digits are read as numbers, other strings evaluate to the sum of
+ * their characters. Arrays and undefined values are 0.
+ *
+ * @param val Value instance.
+ * @return Integer value.
+ */
+long long Value_to_int(const Value *val);
+
+/**
+ * @brief String form of a value.
+ *
+ * Strings are returned as is, anything else is formatted into buff, integers
+ * assigned from a literal as the literal was written.
+ *
+ * @param val Value instance.
+ * @param buff VString used when formatting.
+ * @return Null terminated string, valid until val or buff change.
+ */
+char *Value_to_string(const Value *val, VString *buff);
+
+#endif
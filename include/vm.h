@@ -0,0 +1,29 @@
+/**
+ * @file vm.h
+ * @author Sayed Sadeed
+ * @brief Stack based virtual machine executing Bytecode, see bytecode.h.
+ *
+ * The VM runs a whole program in a single dispatch loop, using computed goto
+ * when the compiler supports it (GCC and Clang) and a switch otherwise. Results
+ * are identical to executing each root with Nexec_exec().
+ */
+
+#ifndef VM_H
+#define VM_H
+
+#include "bytecode.h"
+#include "nexec.h"
+
+/**
+ * @brief Execute a compiled program.
+ *
+ * Symbols, errors and mixed string expansion are shared with nexec_mgr, which
+ * has to be initialised with the FlatAst the program was compiled from.
+ *
+ * @param nexec_mgr Pointer to NexecMgr instance.
+ * @param code Bytecode instance.
+ * @return 0 if success otherwise returns -1.
+ */
+int Vm_run(NexecMgr *nexec_mgr, Bytecode *code);
+
+#endif
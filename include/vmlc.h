@@ -0,0 +1,134 @@
+/**
+ * @file vmlc.h
+ * @author Sayed Sadeed
+ * @brief Compiled script cache (*.vmlc).
+ *
+ * A parsed script is written to a cache file keyed by a hash of its source, holding
+ * the FlatAst, the symbols declared while parsing and the strings both refer to. On the
+ * next run of an unchanged script the cache is mapped and executed from directly,
+ * skipping tokenizing and parsing altogether. The FlatAst arrays point straight into
+ * the mapping and cached strings are interned in place, so the mapping has to outlive
+ * both the FlatAst and the InternPool.
+ *
+ * The layout is the host's native one, a cache is not meant to be moved between machines.
+ * After the header every section is 8 byte aligned and follows in the order below.
+ *
+ *  VmlcHeader
+ *  VmlcString[str_ctr]     FlatAst strs, offset and length into the string bytes.
+ *  unsigned char[node_ctr] FlatAst types.
+ *  unsigned char[node_ctr] FlatAst kwids.
+ *  unsigned int[node_ctr]  FlatAst values.
+ *  unsigned int[node_ctr]  FlatAst lhs.
+ *  unsigned int[node_ctr]  FlatAst rhs.
+ *  unsigned int[kid_ctr]   FlatAst kids.
+ *  unsigned int[root_ctr]  FlatAst roots.
+ *  VmlcSymbol[sym_ctr]
+ *  char[str_bytes]         null terminated strings.
+ */
+
+#ifndef VMLC_H
+#define VMLC_H
+
+#include <stddef.h>
+#include "intern.h"
+#include "sytable.h"
+#include "flatast.h"
+
+#define VMLC_MAGIC "VMLC"
+#define VMLC_VERSION 3
+
+/**
+ * @brief Cache file header.
+ */
+typedef struct {
+	char magic[4];
+	unsigned int version;
+	unsigned long long src_hash;
+	unsigned long long src_len;
+	unsigned int str_ctr;
+	unsigned int node_ctr;
+	unsigned int kid_ctr;
+	unsigned int root_ctr;
+	unsigned int sym_ctr;
+	unsigned int str_bytes;
+} VmlcHeader;
+
+/**
+ * @brief Location of a string inside the string bytes.
+ */
+typedef struct {
+	unsigned int offset;
+	unsigned int length;
+} VmlcString;
+
+/**
+ * @brief Serialized symbol declaration.
+ */
+typedef struct {
+	VmlcString label;
+	unsigned int lineno;
+	unsigned int sy_type;
+} VmlcSymbol;
+
+/**
+ * @brief Mapping of a loaded cache file and the FlatAst borrowing it.
+ */
+typedef struct {
+	void *map;
+	size_t map_len;
+	FlatAst *ast;
+} Vmlc;
+
+/**
+ * @brief Build the cache path for a script.
+ *
+ * The cache directory is $VMEL_CACHE_DIR, otherwise $XDG_CACHE_HOME/vmel or
+ * ~/.cache/vmel. The file is named after the source hash.
+ *
+ * @param path Buffer for the resulting path.
+ * @param size Size of path buffer.
+ * @param src_hash Hash of script source, see buffer_hash64().
+ * @return 0 if successful otherwise -1.
+ */
+int Vmlc_path(char *path, size_t size, unsigned long long src_hash);
+
+/**
+ * @brief Load a cache file, declaring its symbols in an empty SyTable.
+ *
+ * Fails if the cache is missing, stale or malformed in which case sy_table
+ * is left untouched and the script should be parsed as usual.
+ *
+ * @param path Path of cache file.
+ * @param src_hash Hash of script source.
+ * @param src_len Length of script source.
+ * @param pool InternPool cached strings are added to.
+ * @param sy_table SyTable to declare symbols in.
+ * @return Vmlc instance holding the FlatAst, which must outlive pool, or NULL if not loaded.
+ */
+Vmlc *Vmlc_load(const char *path, unsigned long long src_hash, size_t src_len,
+				InternPool *pool, SyTable *sy_table);
+
+/**
+ * @brief Write a parsed script to a cache file.
+ *
+ * The file is written to a temporary name and renamed so concurrent runs never
+ * see a partial cache.
+ *
+ * @param path Path of cache file.
+ * @param src_hash Hash of script source.
+ * @param src_len Length of script source.
+ * @param sy_table SyTable after parsing.
+ * @param ast FlatAst lowered from the parsed script.
+ * @return 0 if successful otherwise -1.
+ */
+int Vmlc_save(const char *path, unsigned long long src_hash, size_t src_len,
+				SyTable *sy_table, FlatAst *ast);
+
+/**
+ * @brief Free the FlatAst and unmap a loaded cache.
+ *
+ * @param vmlc Vmlc instance.
+ */
+void Vmlc_free(Vmlc *vmlc);
+
+#endif
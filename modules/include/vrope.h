@@ -0,0 +1,240 @@
+/**
+ * @file vrope.h
+ * @author Sayed Sadeed
+ * @brief Chunked string for large command output.
+ *
+ * A VRope is a list of chunks which are appended to and never moved, so unlike
+ * a VString growing it never copies what was already written and slices of it,
+ * i.e lines, stay valid for as long as the rope. Chunks start small and double
+ * up to VROPE_CHUNK_MAX. Output is best read straight into the rope:
+ *
+ * @code
+ * VRope out = VRope_new();
+ * size_t avail;
+ * char *buff;
+ * ssize_t n;
+ *
+ * while ((buff = VRope_spare(&out, 1, &avail)) && (n = read(fd, buff, avail)) > 0)
+ *     VRope_commit(&out, n);
+ * @endcode
+ *
+ * Only flatten a rope into a VString, see VRope_flatten(), where a contiguous
+ * buffer is really needed.
+ */
+
+#ifndef VROPE_H
+#define VROPE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "vstring.h"
+
+#define VROPE_CHUNK_MIN 256
+#define VROPE_CHUNK_MAX 65536
+
+/**
+ * @brief Chunk of a VRope, size bytes of data out of cap are in use.
+ */
+typedef struct VRopeChunk {
+	struct VRopeChunk *next;
+	size_t size;
+	size_t cap;
+	char data[];
+} VRopeChunk;
+
+/**
+ * @brief Struct representing a VRope, size being the total length.
+ */
+typedef struct {
+	VRopeChunk *head;
+	VRopeChunk *tail;
+	size_t size;
+	size_t chunk_ctr;
+} VRope;
+
+/**
+ * @brief Position inside a VRope.
+ */
+typedef struct {
+	VRopeChunk *chunk;
+	size_t offset;
+} VRopeIter;
+
+/**
+ * @brief Slice of a VRope, length bytes from a position.
+ *
+ * A span borrows the chunks of its rope and may cover several of them,
+ * walk its pieces with VRopeSpan_next().
+ */
+typedef struct {
+	VRopeChunk *chunk;
+	size_t offset;
+	size_t length;
+} VRopeSpan;
+
+/**
+ * @brief Instantiate a new empty VRope, nothing is allocated.
+ *
+ * @return VRope object.
+ */
+VRope VRope_new(void);
+
+/**
+ * @brief Append n characters to a VRope.
+ *
+ * Characters are copied into the spare room of the last chunk, then
+ * into a new chunk, existing data is never moved.
+ *
+ * @param rope VRope instance.
+ * @param str Characters to append, need not be null terminated.
+ * @param n Number of characters.
+ * @return Pointer to VRope or NULL if failed.
+ */
+VRope *VRope_push(VRope *rope, const char *str, size_t n);
+
+/**
+ * @brief Append a null terminated string to a VRope.
+ *
+ * @param rope VRope instance.
+ * @param str String to append.
+ * @return Pointer to VRope or NULL if failed.
+ */
+VRope *VRope_pushs(VRope *rope, const char *str);
+
+/**
+ * @brief Get spare room at the end of a VRope to write into.
+ *
+ * Adds a chunk if the last one has less than min bytes to spare. What was
+ * written is only part of the rope once passed to VRope_commit().
+ *
+ * @param rope VRope instance.
+ * @param min Minimum number of bytes needed.
+ * @param avail Set to the number of bytes available.
+ * @return Pointer to the spare room or NULL if failed.
+ */
+char *VRope_spare(VRope *rope, size_t min, size_t *avail);
+
+/**
+ * @brief Append n bytes written into the room returned by VRope_spare().
+ *
+ * @param rope VRope instance.
+ * @param n Number of bytes written, at most the room available.
+ */
+void VRope_commit(VRope *rope, size_t n);
+
+/**
+ * @brief Shorten a VRope to its first size bytes.
+ *
+ * Chunks past the new end are freed, spans reaching past it are no longer valid.
+ *
+ * @param rope VRope instance.
+ * @param size New size, ignored unless smaller than the current one.
+ */
+void VRope_truncate(VRope *rope, size_t size);
+
+/**
+ * @brief Get an iterator at the start of a VRope.
+ *
+ * @param rope VRope instance.
+ * @return Iterator.
+ */
+VRopeIter VRope_iter(VRope *rope);
+
+/**
+ * @brief Get the next chunk of data.
+ *
+ * @param iter Iterator, advanced past the data returned.
+ * @param data Set to the data.
+ * @param len Set to the length of data.
+ * @return 1 if there was data otherwise 0.
+ */
+int VRope_next_chunk(VRopeIter *iter, const char **data, size_t *len);
+
+/**
+ * @brief Get the next line.
+ *
+ * The line excludes its '\n', a rope ending with '\n' has no empty last line.
+ * Nothing is copied.
+ *
+ * @code
+ * VRopeIter it = VRope_iter(&out);
+ * VRopeSpan line;
+ *
+ * while (VRope_next_line(&it, &line))
+ *     ...
+ * @endcode
+ *
+ * @param iter Iterator, advanced past the line.
+ * @param line Set to the line.
+ * @return 1 if there was a line otherwise 0.
+ */
+int VRope_next_line(VRopeIter *iter, VRopeSpan *line);
+
+/**
+ * @brief Slice a VRope.
+ *
+ * Locating pos walks the chunks, len is clamped to the end of the rope.
+ *
+ * @param rope VRope instance.
+ * @param pos Offset of the slice.
+ * @param len Length of the slice.
+ * @param span Set to the slice.
+ * @return 0 if successful otherwise -1 if pos is past the end.
+ */
+int VRope_slice(VRope *rope, size_t pos, size_t len, VRopeSpan *span);
+
+/**
+ * @brief Get the next contiguous piece of a span.
+ *
+ * @param span Span, consumed by the piece returned.
+ * @param data Set to the piece.
+ * @param len Set to the length of the piece.
+ * @return 1 if there was a piece otherwise 0.
+ */
+int VRopeSpan_next(VRopeSpan *span, const char **data, size_t *len);
+
+/**
+ * @brief Get a span as a single pointer without copying.
+ *
+ * @param span Span.
+ * @return Pointer to span, which isn't null terminated, or NULL if it crosses chunks.
+ */
+const char *VRopeSpan_ptr(const VRopeSpan *span);
+
+/**
+ * @brief Copy a span into a VString, replacing its contents.
+ *
+ * @param span Span.
+ * @param vstr VString instance.
+ * @return Pointer to string or NULL if failed.
+ */
+char *VRopeSpan_flatten(const VRopeSpan *span, VString *vstr);
+
+/**
+ * @brief Copy a whole VRope into a VString, replacing its contents.
+ *
+ * @param rope VRope instance.
+ * @param vstr VString instance.
+ * @return Pointer to string or NULL if failed.
+ */
+char *VRope_flatten(VRope *rope, VString *vstr);
+
+/**
+ * @brief Write a whole VRope to a stream, chunk by chunk.
+ *
+ * @param rope VRope instance.
+ * @param stream Stream to write to.
+ * @return Number of bytes written.
+ */
+size_t VRope_fwrite(VRope *rope, FILE *stream);
+
+/**
+ * @brief Free resources.
+ *
+ * The VRope is left empty and may be reused.
+ *
+ * @param rope VRope instance.
+ */
+void VRope_free(VRope *rope);
+
+#endif
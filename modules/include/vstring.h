@@ -14,18 +14,33 @@
 /**
  * @brief Struct representing a VString.
  * 
+ * Strings of up to INIT_STRING_SIZE chars live in the inline buffer sso and
+ * only spill to heap once they outgrow it, str_cap being the size of whichever
+ * buffer is in use. No pointer into the struct itself is kept so a VString may
+ * be returned and copied by value, read the string through VString_str().
  */
 typedef struct {
 	size_t str_size;
 	size_t str_cap;
-	char *str;
+	char *heap;
+	char sso[INIT_STRING_SIZE + 1];
 } VString;
 
+/**
+ * @brief Get the null terminated string of a VString.
+ * 
+ * @param vstr VString instance.
+ * @return Pointer to string.
+ */
+static inline char *VString_str(VString *vstr) {
+	return vstr->str_cap <= sizeof(vstr->sso) ? vstr->sso : vstr->heap;
+}
+
 /**
  * @brief Instantiate a new empty VString string object.
  * 
- * Function will create an emptu VString object along with a
- * malloc'ed str based on default size.
+ * Function will create an empty VString object using its inline
+ * buffer, nothing is allocated.
  * 
  * @return VString object.
  */
@@ -68,12 +83,67 @@ VString *VString_pushc(VString *vstr, char c);
 VString *VString_pushs(VString *vstr, char *str);
 
 
+/**
+ * @brief Push the first n characters of a string into a VString.
+ * 
+ * Same as VString_pushs() but str need not be null terminated, nor is
+ * its length looked up. str may point into vstr itself.
+ * 
+ * @param vstr VString instance.
+ * @param str String to append to instance.
+ * @param n Number of characters to append.
+ * @return Pointer to VString.
+ */
+VString *VString_pushn(VString *vstr, const char *str, size_t n);
+
+/**
+ * @brief Make sure a VString can hold a string of size characters.
+ * 
+ * Useful ahead of a number of pushes whose total size is known, so
+ * the buffer is grown at most once. Like every push, growing at least
+ * doubles the capacity.
+ * 
+ * @param vstr VString instance.
+ * @param size Number of characters, excluding the terminator.
+ * @return Pointer to VString or NULL if failed.
+ */
+VString *VString_reserve(VString *vstr, size_t size);
+
+/**
+ * @brief Push a formatted string into a VString.
+ * 
+ * Formats with vsnprintf() straight into the spare capacity, so
+ * no temporary buffer is needed. Arguments must not point into vstr.
+ * 
+ * @code
+ * VString_pushf(&cmd, "ssh -p %d %s@%s", port, user, host);
+ * @endcode
+ * 
+ * @param vstr VString instance.
+ * @param fmt printf() style format.
+ * @return Pointer to VString or NULL if failed, leaving vstr as it was.
+ */
+VString *VString_pushf(VString *vstr, const char *fmt, ...)
+#if defined(__GNUC__)
+	__attribute__((format(printf, 2, 3)))
+#endif
+	;
+
+/**
+ * @brief Empty a VString keeping its capacity.
+ * 
+ * @param vstr VString instance.
+ * @return Pointer to VString.
+ */
+VString *VString_clear(VString *vstr);
+
 /**
  * @brief Instantiate a new VString instance with a string parameter.
  * 
  * Create a VString object and set the string value 
  * as the passed str parameter. It is also possible to set the capcity using
- * the second paramter cap. This will allocate the buffer size to equate to cap.
+ * the second paramter cap. This will allocate the buffer size to equate to cap,
+ * capacities up to INIT_STRING_SIZE use the inline buffer instead.
  * Note that there is no implicit enforcement on fixed sizing however it will help
  * lessen memory wastage if known string sizes are instantiated with an explicit capacity.
  * 
@@ -88,11 +158,24 @@ VString *VString_pushs(VString *vstr, char *str);
  */
 VString VString_create(char *str, size_t cap); 
 
+/**
+ * @brief Replace every occurrence of a string.
+ * 
+ * Occurrences are found left to right without overlapping and the result
+ * is built in a single pass, replaced text is never searched again.
+ * 
+ * @param vstr VString instance.
+ * @param find String to find.
+ * @param replace String to replace it with.
+ * @return 0 if successful otherwise -1.
+ */
 int VString_replace(VString *vstr, char *find, char *replace);
 
 /**
  * @brief Free resources.
  * 
+ * The VString is left empty and may be reused.
+ * 
  * @param vstr Pointer to VString object.
  */
 int VString_free(VString *vstr);
@@ -0,0 +1,272 @@
+#include <stdlib.h>
+#include <string.h>
+#include "vrope.h"
+
+// Append an empty chunk of at least min bytes, chunks doubling up to VROPE_CHUNK_MAX.
+static VRopeChunk *VRope_add_chunk(VRope *rope, size_t min) {
+	size_t cap = rope->tail ? rope->tail->cap * 2 : VROPE_CHUNK_MIN;
+
+	if (cap > VROPE_CHUNK_MAX)
+		cap = VROPE_CHUNK_MAX;
+	if (cap < min)
+		cap = min;
+
+	VRopeChunk *chunk = malloc(sizeof(VRopeChunk) + cap);
+	if (!chunk)
+		return NULL;
+
+	chunk->next = NULL;
+	chunk->size = 0;
+	chunk->cap = cap;
+
+	if (rope->tail)
+		rope->tail->next = chunk;
+	else
+		rope->head = chunk;
+	rope->tail = chunk;
+	rope->chunk_ctr++;
+	return chunk;
+}
+
+// Move an iterator off the end of its chunk, skipping empty ones.
+static void VRope_settle(VRopeChunk **chunk, size_t *offset) {
+	while (*chunk && *offset == (*chunk)->size) {
+		*chunk = (*chunk)->next;
+		*offset = 0;
+	}
+}
+
+VRope VRope_new(void) {
+	VRope rope = { NULL, NULL, 0, 0 };
+	return rope;
+}
+
+VRope *VRope_push(VRope *rope, const char *str, size_t n) {
+	if (!rope || (!str && n))
+		return NULL;
+
+	while (n) {
+		size_t avail;
+		char *buff = VRope_spare(rope, 1, &avail);
+
+		if (!buff)
+			return NULL;
+		if (avail > n)
+			avail = n;
+
+		memcpy(buff, str, avail);
+		VRope_commit(rope, avail);
+		str += avail;
+		n -= avail;
+	}
+
+	return rope;
+}
+
+VRope *VRope_pushs(VRope *rope, const char *str) {
+	if (!str)
+		return NULL;
+
+	return VRope_push(rope, str, strlen(str));
+}
+
+char *VRope_spare(VRope *rope, size_t min, size_t *avail) {
+	if (!rope || !avail)
+		return NULL;
+
+	VRopeChunk *chunk = rope->tail;
+	if (!min)
+		min = 1;
+
+	if (!chunk || chunk->cap - chunk->size < min)
+		chunk = VRope_add_chunk(rope, min);
+	if (!chunk)
+		return NULL;
+
+	*avail = chunk->cap - chunk->size;
+	return chunk->data + chunk->size;
+}
+
+void VRope_commit(VRope *rope, size_t n) {
+	if (!rope || !rope->tail)
+		return;
+
+	rope->tail->size += n;
+	rope->size += n;
+}
+
+void VRope_truncate(VRope *rope, size_t size) {
+	if (!rope || size >= rope->size)
+		return;
+
+	// Find the chunk the new end falls in, a full chunk is kept as is.
+	VRopeChunk *chunk = rope->head;
+	size_t pos = size;
+	while (pos > chunk->size) {
+		pos -= chunk->size;
+		chunk = chunk->next;
+	}
+
+	VRopeChunk *next = chunk->next;
+	while (next) {
+		VRopeChunk *tmp = next->next;
+		free(next);
+		next = tmp;
+		rope->chunk_ctr--;
+	}
+
+	chunk->next = NULL;
+	chunk->size = pos;
+	rope->tail = chunk;
+	rope->size = size;
+}
+
+VRopeIter VRope_iter(VRope *rope) {
+	VRopeIter iter = { rope ? rope->head : NULL, 0 };
+	return iter;
+}
+
+int VRope_next_chunk(VRopeIter *iter, const char **data, size_t *len) {
+	VRope_settle(&iter->chunk, &iter->offset);
+	if (!iter->chunk)
+		return 0;
+
+	*data = iter->chunk->data + iter->offset;
+	*len = iter->chunk->size - iter->offset;
+	iter->offset = iter->chunk->size;
+	return 1;
+}
+
+int VRope_next_line(VRopeIter *iter, VRopeSpan *line) {
+	VRope_settle(&iter->chunk, &iter->offset);
+	if (!iter->chunk)
+		return 0;
+
+	line->chunk = iter->chunk;
+	line->offset = iter->offset;
+	line->length = 0;
+
+	// Scan chunk by chunk, a line may run across any number of them.
+	while (iter->chunk) {
+		VRopeChunk *chunk = iter->chunk;
+		char *start = chunk->data + iter->offset;
+		char *nl = memchr(start, '\n', chunk->size - iter->offset);
+
+		if (nl) {
+			line->length += nl - start;
+			iter->offset += nl - start + 1;
+			return 1;
+		}
+
+		line->length += chunk->size - iter->offset;
+		iter->chunk = chunk->next;
+		iter->offset = 0;
+	}
+
+	return 1;
+}
+
+int VRope_slice(VRope *rope, size_t pos, size_t len, VRopeSpan *span) {
+	if (!rope || !span || pos > rope->size)
+		return -1;
+
+	if (len > rope->size - pos)
+		len = rope->size - pos;
+
+	VRopeChunk *chunk = rope->head;
+	while (chunk && pos >= chunk->size && chunk->next) {
+		pos -= chunk->size;
+		chunk = chunk->next;
+	}
+
+	span->chunk = chunk;
+	span->offset = pos;
+	span->length = len;
+	return 0;
+}
+
+int VRopeSpan_next(VRopeSpan *span, const char **data, size_t *len) {
+	if (!span->length)
+		return 0;
+
+	VRope_settle(&span->chunk, &span->offset);
+	if (!span->chunk)
+		return 0;
+
+	size_t n = span->chunk->size - span->offset;
+	if (n > span->length)
+		n = span->length;
+
+	*data = span->chunk->data + span->offset;
+	*len = n;
+	span->offset += n;
+	span->length -= n;
+	return 1;
+}
+
+const char *VRopeSpan_ptr(const VRopeSpan *span) {
+	VRopeChunk *chunk = span->chunk;
+	size_t offset = span->offset;
+
+	VRope_settle(&chunk, &offset);
+	if (!chunk)
+		return span->length ? NULL : "";
+
+	return chunk->size - offset >= span->length ? chunk->data + offset : NULL;
+}
+
+char *VRopeSpan_flatten(const VRopeSpan *span, VString *vstr) {
+	if (!span || !vstr)
+		return NULL;
+
+	VRopeSpan it = *span;
+	const char *data;
+	size_t len;
+
+	VString_clear(vstr);
+	if (!VString_reserve(vstr, span->length))
+		return NULL;
+
+	while (VRopeSpan_next(&it, &data, &len))
+		VString_pushn(vstr, data, len);
+
+	return VString_str(vstr);
+}
+
+char *VRope_flatten(VRope *rope, VString *vstr) {
+	VRopeSpan all;
+
+	if (VRope_slice(rope, 0, rope ? rope->size : 0, &all) == -1)
+		return NULL;
+
+	return VRopeSpan_flatten(&all, vstr);
+}
+
+size_t VRope_fwrite(VRope *rope, FILE *stream) {
+	if (!rope || !stream)
+		return 0;
+
+	VRopeIter it = VRope_iter(rope);
+	const char *data;
+	size_t len;
+	size_t written = 0;
+
+	while (VRope_next_chunk(&it, &data, &len))
+		written += fwrite(data, 1, len, stream);
+
+	return written;
+}
+
+void VRope_free(VRope *rope) {
+	if (!rope)
+		return;
+
+	VRopeChunk *chunk = rope->head;
+	while (chunk) {
+		VRopeChunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+
+	*rope = VRope_new();
+}
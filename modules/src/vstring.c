@@ -1,12 +1,38 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include "vstring.h"
 
-// Implicit function to allocate more memory for string.
-static VString *VString_grow_str(VString *vstr, size_t factor) {
+#if defined(__GNUC__)
+	#define VSTRING_NOINLINE __attribute__((noinline))
+#else
+	#define VSTRING_NOINLINE
+#endif
+
+// Determine if the string lives in the inline buffer.
+static int VString_is_inline(VString *vstr) {
+	return vstr->str_cap <= sizeof(vstr->sso);
+}
+
+// Implicit function to allocate more memory for string, spilling an inline string to the heap.
+// Kept out of line so the common case of pushing into a big enough buffer stays cheap.
+VSTRING_NOINLINE static VString *VString_grow_str(VString *vstr, size_t factor) {
 	size_t str_cap = sizeof(char) * factor;
-	char *new_str = realloc(vstr->str, str_cap);
-	vstr->str = new_str;
+	char *new_str = NULL;
+
+	if (VString_is_inline(vstr)) {
+		new_str = malloc(str_cap);
+		if (new_str)
+			memcpy(new_str, vstr->sso, vstr->str_size + 1);
+	}
+	else {
+		new_str = realloc(vstr->heap, str_cap);
+	}
+
+	if (!new_str)
+		return NULL;
+
+	vstr->heap = new_str;
 	vstr->str_cap = str_cap;
 	return vstr;
 }
@@ -16,21 +42,29 @@ static int VString_needs_grow(VString *vstr, size_t n_size) {
 	return n_size >= vstr->str_cap;
 }
 
+// Make room for a string of n_size chars. Every grow at least doubles the capacity
+// so any sequence of appends is amortized linear.
+static VString *VString_fit(VString *vstr, size_t n_size) {
+	if (!VString_needs_grow(vstr, n_size))
+		return vstr;
+
+	size_t str_cap = vstr->str_cap * 2;
+	return VString_grow_str(vstr, str_cap > n_size ? str_cap : n_size + 1);
+}
+
 VString VString_new(void) {
 	VString vstr;
-	vstr.str_cap = INIT_STRING_SIZE;
+	vstr.str_cap = sizeof(vstr.sso);
 	vstr.str_size = 0;
-	vstr.str = malloc(vstr.str_cap * sizeof(char) + 1);
-	*vstr.str = '\0';
+	vstr.heap = NULL;
+	*vstr.sso = '\0';
 	return vstr;
 }
 
 VString VString_create(char *str, size_t cap) {
-	VString vstr;
-	vstr.str_cap = cap < 1 ? INIT_STRING_SIZE : cap;
-	vstr.str_size = 0;
-	vstr.str = malloc(vstr.str_cap * sizeof(char) + 1);
-	*vstr.str = '\0';
+	VString vstr = VString_new();
+	if (cap > INIT_STRING_SIZE && !VString_reserve(&vstr, cap))
+		return vstr;
 	if (str) 
 		VString_pushs(&vstr, str);
 	return vstr;
@@ -42,12 +76,11 @@ VString *VString_set(VString *vstr, char *str) {
 	
 	size_t n_size = strlen(str);
 	
-	if (VString_needs_grow(vstr, n_size)) {
-		VString *n_vstr = VString_grow_str(vstr, n_size * 2);
-		vstr = n_vstr;
-	}
+	// A str inside the buffer is never longer than it, so it never moves.
+	if (!VString_fit(vstr, n_size))
+		return NULL;
 
-	strncpy(vstr->str, str, strlen(str)+1);
+	memmove(VString_str(vstr), str, n_size + 1);
 	vstr->str_size = n_size;
 	return vstr;
 }
@@ -58,13 +91,12 @@ VString *VString_pushc(VString *vstr, char c) {
 
 	size_t n_size = vstr->str_size + sizeof(char);
 	
-	if (VString_needs_grow(vstr, n_size)) {
-		VString *n_vstr = VString_grow_str(vstr, n_size * 8);
-		vstr = n_vstr;
-	}
+	if (!VString_fit(vstr, n_size))
+		return NULL;
 
-	vstr->str[n_size-1] = c;
-	vstr->str[n_size] = '\0';
+	char *buf = VString_str(vstr);
+	buf[n_size-1] = c;
+	buf[n_size] = '\0';
 	vstr->str_size = n_size;
 	return vstr;
 }
@@ -73,18 +105,90 @@ VString *VString_pushs(VString *vstr, char *str) {
 	if (!vstr || !str)
 		return NULL;
 	
-	size_t n_size = vstr->str_size + strlen(str);
-	
-	if (VString_needs_grow(vstr, n_size)) {
-		VString *n_vstr = VString_grow_str(vstr, n_size * 2);
-		vstr = n_vstr;
+	return VString_pushn(vstr, str, strlen(str));
+}
+
+VString *VString_pushn(VString *vstr, const char *str, size_t n) {
+	if (!vstr || !str)
+		return NULL;
+
+	size_t n_size = vstr->str_size + n;
+
+	// Appending part of itself, find it again once the buffer moved.
+	char *buf = VString_str(vstr);
+	if (str >= buf && str < buf + vstr->str_cap) {
+		size_t offset = str - buf;
+		if (!VString_fit(vstr, n_size))
+			return NULL;
+		str = VString_str(vstr) + offset;
+	}
+	else if (!VString_fit(vstr, n_size)) {
+		return NULL;
 	}
 
-	strncat(vstr->str, str, strlen(str));
+	buf = VString_str(vstr);
+	memmove(buf + vstr->str_size, str, n);
+	buf[n_size] = '\0';
 	vstr->str_size = n_size;
 	return vstr;
 }
 
+VString *VString_reserve(VString *vstr, size_t size) {
+	if (!vstr)
+		return NULL;
+
+	return VString_fit(vstr, size);
+}
+
+VString *VString_pushf(VString *vstr, const char *fmt, ...) {
+	if (!vstr || !fmt)
+		return NULL;
+
+	va_list args;
+	size_t spare = vstr->str_cap - vstr->str_size;
+
+	// Format straight into the spare capacity, only formatting again if it didn't fit.
+	va_start(args, fmt);
+	int len = vsnprintf(VString_str(vstr) + vstr->str_size, spare, fmt, args);
+	va_end(args);
+
+	if (len >= 0 && (size_t) len >= spare) {
+		if (VString_fit(vstr, vstr->str_size + len)) {
+			va_start(args, fmt);
+			vsnprintf(VString_str(vstr) + vstr->str_size, len + 1, fmt, args);
+			va_end(args);
+		}
+		else {
+			len = -1;
+		}
+	}
+
+	if (len < 0) {
+		VString_str(vstr)[vstr->str_size] = '\0';
+		return NULL;
+	}
+
+	vstr->str_size += len;
+	return vstr;
+}
+
+VString *VString_clear(VString *vstr) {
+	if (!vstr)
+		return NULL;
+
+	VString_str(vstr)[0] = '\0';
+	vstr->str_size = 0;
+	return vstr;
+}
+
+// Take over the buffer of a VString built in place of vstr.
+static void VString_take(VString *vstr, VString *built) {
+	if (!VString_is_inline(vstr))
+		free(vstr->heap);
+
+	*vstr = *built;
+}
+
 int VString_replace(VString *vstr, char *find, char *replace) {
 	if (!vstr || !find || !replace)
 		return -1;
@@ -94,79 +198,47 @@ int VString_replace(VString *vstr, char *find, char *replace) {
 
 	if (len_find < 1)
 		return 0;
-	
+
+	// Start of text not yet copied.
+	char *itr = VString_str(vstr);
+	// Next occurrence.
+	char *match = strstr(itr, find);
+
+	if (!match)
+		return 0;
+
 	// Length of replace value.
 	size_t len_rep = strlen(replace);
-	// Number of occurrences in source/haystack.
-	int num_finds = 0;
-	// Iterator pointer.
-	char *itr = vstr->str;
-	// Pointer to original source.
-	char *hstack = vstr->str;
-	// Length of original source;
-	size_t len_hstack = vstr->str_size;
-	// Last word in string.
-	char *lword = itr + len_hstack - len_find;
-
-	for (num_finds = 0; (itr = strstr(itr, find)); num_finds++) {
-		itr += len_find;
-	}
+	// Result is built separately so every char is copied once.
+	VString out = VString_new();
+	int failed = !VString_reserve(&out, vstr->str_size);
 
-	// Find new size of string.
-	len_hstack = len_hstack - ((len_find - len_rep) * num_finds);
-
-	while (num_finds--) {
-		itr = strstr(hstack, find);
-
-		// A shrink.
-		if (len_find > len_rep) {
-			
-			// Only shift to the left if source is not last word.
-			// "Hello source" <--- no left shit required.
-			// "Hello source there" <--- left shift required.
-			if (itr != lword)
-				memmove((itr + len_find) - (len_find - len_rep), itr + len_find, vstr->str_size - len_find); 
-			
-			memmove(itr, replace, len_rep);
-		}
-		// A grow.
-		else if (len_find < len_rep) {
-			if (VString_needs_grow(vstr, len_hstack)) {
-				VString *n_vstr = VString_grow_str(vstr, len_hstack * 2);
-				
-				if (!n_vstr)
-					return -1;
-				
-				// After realloc reassign pointers.
-				vstr = n_vstr;
-				hstack = vstr->str;
-				itr = strstr(hstack, find);
-			}
-
-			// Only shift to the right if source is not last word.
-			// "Hello bigger source" <--- no right shit required.
-			// "Hello bigger source there" <--- right shift required.
-			if (itr != lword)
-				memmove(itr + len_rep, itr + len_find, vstr->str_size - len_find); 
-			
-			memmove(itr, replace, len_rep);
-		}
-		// A direct copy.
-		else if (len_find == len_rep) {
-			memmove(itr, replace, len_rep);
-		}
+	for (; match && !failed; itr = match + len_find, match = strstr(itr, find)) {
+		failed |= !VString_pushn(&out, itr, match - itr);
+		failed |= !VString_pushn(&out, replace, len_rep);
 	}
 
-	vstr->str_size = len_hstack;
-	vstr->str[len_hstack] = '\0';
+	failed |= !VString_pushn(&out, itr, vstr->str_size - (itr - VString_str(vstr)));
+
+	if (failed) {
+		VString_free(&out);
+		return -1;
+	}
 
+	VString_take(vstr, &out);
 	return 0;
 }
 
 int VString_free(VString *vstr) {
-	if (!vstr->str)
+	if (!vstr)
 		return -1;
 
-	free(vstr->str);
+	if (!VString_is_inline(vstr))
+		free(vstr->heap);
+
+	vstr->str_cap = sizeof(vstr->sso);
+	vstr->str_size = 0;
+	vstr->heap = NULL;
+	*vstr->sso = '\0';
 	return 0;
 }
@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include <stdalign.h>
+#include "arena.h"
+#include "utils.h"
+
+#define ARENA_ALIGN alignof(max_align_t)
+
+// Round up to the next multiple of ARENA_ALIGN.
+static size_t align_up(size_t n) {
+	return (n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+// Chain a new block big enough to hold at least size bytes.
+static ArenaBlock *arena_grow(Arena *arena, size_t size) {
+	size_t cap = size > arena->block_size ? size : arena->block_size;
+	ArenaBlock *blk = malloc(sizeof(ArenaBlock) + cap);
+
+	if (!blk)
+		return NULL;
+
+	blk->prev = arena->head;
+	blk->used = 0;
+	blk->cap = cap;
+	arena->head = blk;
+	arena->total += cap;
+	return blk;
+}
+
+Arena *Arena_new(size_t block_size) {
+	Arena *arena = malloc(sizeof(Arena));
+	arena->head = NULL;
+	arena->block_size = block_size ? block_size : INIT_ARENA_BLOCK_SIZE;
+	arena->total = 0;
+	return arena;
+}
+
+void *Arena_alloc_bytes(Arena *arena, size_t size) {
+	if (null_check(arena, "arena alloc")) return NULL;
+
+	ArenaBlock *blk = arena->head;
+
+	if (!blk || blk->cap - blk->used < size) {
+		if (!(blk = arena_grow(arena, size)))
+			return NULL;
+	}
+
+	void *ptr = (char *) blk->data + blk->used;
+	blk->used += size;
+	return ptr;
+}
+
+void *Arena_alloc(Arena *arena, size_t size) {
+	if (null_check(arena, "arena alloc")) return NULL;
+
+	ArenaBlock *blk = arena->head;
+
+	// Blocks start aligned so aligning the offset is enough.
+	if (blk) {
+		size_t off = align_up(blk->used);
+		blk->used = off < blk->cap ? off : blk->cap;
+	}
+
+	return Arena_alloc_bytes(arena, align_up(size));
+}
+
+void Arena_reset(Arena *arena) {
+	if (null_check(arena, "arena reset")) return;
+
+	ArenaBlock *blk = arena->head;
+
+	if (!blk)
+		return;
+
+	// Keep the newest block, it is at least as large as block_size.
+	while (blk->prev) {
+		ArenaBlock *prev = blk->prev;
+		blk->prev = prev->prev;
+		arena->total -= prev->cap;
+		free(prev);
+	}
+	blk->used = 0;
+}
+
+void Arena_free(Arena *arena) {
+	if (null_check(arena, "arena free")) return;
+
+	ArenaBlock *blk = arena->head;
+
+	while (blk) {
+		ArenaBlock *prev = blk->prev;
+		free(blk);
+		blk = prev;
+	}
+	free(arena);
+}
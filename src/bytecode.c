@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bytecode.h"
+#include "tokens.h"
+#include "utils.h"
+
+/**
+ * @brief State used while compiling.
+ */
+typedef struct {
+	Bytecode *code;
+	size_t depth;
+	int failed;
+} BcCompiler;
+
+// Append an instruction.
+static void bc_emit(BcCompiler *bc, enum Opcode op, unsigned int a, unsigned int b) {
+	Bytecode *code = bc->code;
+
+	if (code->code_ctr == code->code_cap) {
+		size_t cap = code->code_cap ? code->code_cap * 2 : 256;
+		Instr *code_new = realloc(code->code, cap * sizeof(Instr));
+
+		if (!code_new) {
+			bc->failed = 1;
+			return;
+		}
+		code->code = code_new;
+		code->code_cap = cap;
+	}
+
+	code->code[code->code_ctr++] = (Instr) { op, a, b };
+}
+
+// Push a 64 bit immediate, split across both operands.
+static void bc_push_int(BcCompiler *bc, long long num) {
+	unsigned long long bits = (unsigned long long) num;
+	bc_emit(bc, BC_PUSH_INT, (unsigned int) bits, (unsigned int) (bits >> 32));
+}
+
+// Track stack depth, delta being the number of values pushed minus popped.
+static void bc_stack(BcCompiler *bc, int delta) {
+	bc->depth += delta;
+	if (bc->depth > bc->code->stack_max)
+		bc->code->stack_max = bc->depth;
+}
+
+// Compile an expression leaving its integer value on the stack.
+static void bc_expression(BcCompiler *bc, FlatIdx node) {
+	static const unsigned char Ops[] = {
+		[E_ADD_NODE] = BC_ADD, [E_TIMES_NODE] = BC_MUL,
+		[E_DIV_NODE] = BC_DIV, [E_MINUS_NODE] = BC_SUB,
+		[E_EEQUAL_NODE] = BC_EQ, [E_NEQUAL_NODE] = BC_NE,
+		[E_LESSTHAN_NODE] = BC_LT, [E_LESSTHANEQ_NODE] = BC_LE,
+		[E_GREATERTHAN_NODE] = BC_GT, [E_GREATERTHANEQ_NODE] = BC_GE,
+		[E_BETWEEN_NODE] = BC_HALT
+	};
+	FlatAst *ast = bc->code->ast;
+	enum NodeType type = FlatAst_type(ast, node);
+	char *value = FlatAst_value(ast, node);
+
+	switch (type) {
+		case E_INTEGER_NODE:
+			bc_push_int(bc, string_to_int64(value, strlen(value)));
+			break;
+		case E_STRING_NODE:
+			bc_push_int(bc, string_to_ascii(value));
+			break;
+		case E_MIXSTR_NODE:
+			bc_emit(bc, BC_PUSH_MIXSTR, ast->values[node], 0);
+			break;
+		case E_IDENTIFIER_NODE:
+			bc_emit(bc, BC_PUSH_VAR, ast->rhs[node], ast->values[node]);
+			break;
+		default:
+			// Operators without an opcode, i.e between, evaluate to 0 as do other nodes.
+			if ((FlatAst_is_binop(type) || FlatAst_is_compare(type)) && Ops[type] != BC_HALT) {
+				bc_expression(bc, ast->lhs[node]);
+				bc_expression(bc, ast->rhs[node]);
+				bc_emit(bc, Ops[type], 0, 0);
+				bc_stack(bc, -1);
+				return;
+			}
+			bc_push_int(bc, 0);
+			break;
+	}
+
+	bc_stack(bc, 1);
+}
+
+// Compile a print function.
+static void bc_print(BcCompiler *bc, FlatIdx args) {
+	FlatAst *ast = bc->code->ast;
+
+	switch (FlatAst_type(ast, args)) {
+		case E_STRING_NODE:
+		case E_INTEGER_NODE:
+			bc_emit(bc, BC_PRINT_STR, ast->values[args], 0);
+			break;
+		case E_IDENTIFIER_NODE:
+			bc_emit(bc, BC_PRINT_VAR, ast->rhs[args], ast->values[args]);
+			break;
+		case E_MIXSTR_NODE:
+			bc_emit(bc, BC_PRINT_MIXSTR, ast->values[args], 0);
+			break;
+		default:
+			bc_expression(bc, args);
+			bc_emit(bc, BC_PRINT_INT, 0, 0);
+			bc_stack(bc, -1);
+			break;
+	}
+}
+
+// Compile an assignment.
+static void bc_assignment(BcCompiler *bc, FlatIdx node) {
+	FlatAst *ast = bc->code->ast;
+	FlatIdx right = ast->rhs[node];
+	enum NodeType right_type = FlatAst_type(ast, right);
+	unsigned int slot = ast->rhs[ast->lhs[node]];
+
+	if (right_type == E_STRING_NODE) {
+		bc_emit(bc, BC_STORE_STR, slot, ast->values[right]);
+	}
+	else if (right_type == E_IDENTIFIER_NODE) {
+		bc_emit(bc, BC_STORE_VAR, slot, ast->rhs[right]);
+	}
+	else if (right_type == E_INTEGER_NODE) {
+		bc_expression(bc, right);
+		bc_emit(bc, BC_STORE_LIT, slot, ast->values[right]);
+		bc_stack(bc, -1);
+	}
+	else if (FlatAst_is_binop(right_type) || FlatAst_is_compare(right_type)) {
+		bc_expression(bc, right);
+		bc_emit(bc, FlatAst_is_compare(right_type) ? BC_STORE_BOOL : BC_STORE_INT, slot, 0);
+		bc_stack(bc, -1);
+	}
+	else if (right_type == E_MIXSTR_NODE) {
+		bc_emit(bc, BC_STORE_MIXSTR, slot, ast->values[right]);
+	}
+	else if (right_type == E_ARRAY_NODE) {
+		bc_emit(bc, BC_STORE_ARRAY, slot, right);
+	}
+}
+
+Bytecode *Bytecode_compile(FlatAst *ast) {
+	if (null_check(ast, "bytecode compile")) return NULL;
+
+	Bytecode *code = calloc(1, sizeof(Bytecode));
+	BcCompiler bc = { code, 0, 0 };
+
+	if (null_check(code, "bytecode compile"))
+		return NULL;
+
+	code->ast = ast;
+
+	for (size_t i = 0; i < ast->root_ctr && !bc.failed; i++) {
+		FlatIdx root = ast->roots[i];
+
+		bc_emit(&bc, BC_STMT, root, 0);
+		switch (FlatAst_type(ast, root)) {
+			case E_FUNC_NODE:
+				if (ast->kwids[root] == E_KW_PRINT)
+					bc_print(&bc, ast->lhs[root]);
+				break;
+			case E_EQUAL_NODE:
+				bc_assignment(&bc, root);
+				break;
+			case E_GROUP_NODE:
+				bc_emit(&bc, BC_GROUP, root, 0);
+				break;
+			default:
+				break;
+		}
+		bc_emit(&bc, BC_END_STMT, 0, 0);
+	}
+
+	bc_emit(&bc, BC_HALT, 0, 0);
+
+	if (bc.failed) {
+		Bytecode_free(code);
+		return NULL;
+	}
+
+	return code;
+}
+
+void Bytecode_free(Bytecode *code) {
+	if (null_check(code, "bytecode free")) return;
+
+	free(code->code);
+	free(code);
+}
@@ -0,0 +1,465 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+#include "evloop.h"
+#include "utils.h"
+
+// Descriptors of a session, an epoll tag being its slot * 4 + one of these.
+#define EV_OUT 0
+#define EV_ERR 1
+#define EV_PID 2
+
+// Descriptors a host needs while its command is spawned, both ends of two pipes.
+#define EV_HOST_FDS 4
+
+// Descriptors left to the rest of the program when bounding active hosts.
+#define EV_RESERVED_FDS 16
+
+#define EV_TIMER_TAG UINT64_MAX
+#define EV_EVENTS 256
+
+// Exit status of a command which wasn't reaped yet.
+#define EV_RUNNING -2
+
+/**
+ * @brief Host being run in a slot of the loop.
+ *
+ * cmd is the index of the running command and seq counts the commands started in
+ * the slot, telling deadlines of earlier commands apart. fds are the stdout and
+ * stderr pipes and pidfd of the command, -1 once closed or if pidfds aren't supported.
+ */
+typedef struct {
+	HostResult *host;
+	TransportSession *session;
+	size_t cmd;
+	pid_t pid;
+	int fds[3];
+	int status;
+	int timed_out;
+	unsigned int seq;
+	unsigned long long started;
+} EvSession;
+
+/**
+ * @brief Deadline of a command, stale once the slot moved on to another command.
+ */
+typedef struct {
+	unsigned long long deadline;
+	size_t slot;
+	unsigned int seq;
+} EvTimer;
+
+/**
+ * @brief State of a run, heap being a min heap of deadlines.
+ */
+typedef struct {
+	int epfd;
+	int tfd;
+	Transport *transport;
+	char **cmds;
+	size_t cmd_ctr;
+	HostResult *hosts;
+	size_t host_ctr;
+	size_t next_host;
+	EvSession *slots;
+	size_t slot_ctr;
+	size_t active;
+	EvTimer *heap;
+	size_t heap_ctr;
+	size_t heap_cap;
+	unsigned int timeout_ms;
+} EvLoop;
+
+// Monotonic clock in nanoseconds.
+static unsigned long long ev_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Convert a wait status to the exit code a shell would report.
+static int ev_exit_status(int status) {
+	if (WIFEXITED(status))
+		return WEXITSTATUS(status);
+	if (WIFSIGNALED(status))
+		return 128 + WTERMSIG(status);
+	return -1;
+}
+
+// Get a descriptor which becomes readable once pid exits, -1 where unsupported.
+static int ev_pidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+	return (int) syscall(SYS_pidfd_open, pid, 0);
+#else
+	(void) pid;
+	return -1;
+#endif
+}
+
+// Arm the timer for the earliest deadline, disarming it if there is none.
+static void ev_arm(EvLoop *loop) {
+	struct itimerspec its = { { 0, 0 }, { 0, 0 } };
+
+	if (loop->heap_ctr) {
+		its.it_value.tv_sec = loop->heap[0].deadline / 1000000000ull;
+		its.it_value.tv_nsec = loop->heap[0].deadline % 1000000000ull;
+	}
+
+	timerfd_settime(loop->tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+// Add a deadline, sifting it up the heap.
+static int ev_heap_push(EvLoop *loop, EvTimer timer) {
+	if (loop->heap_ctr == loop->heap_cap) {
+		size_t n_cap = loop->heap_cap ? loop->heap_cap * 2 : 64;
+		EvTimer *n_heap = realloc(loop->heap, n_cap * sizeof(EvTimer));
+
+		if (!n_heap)
+			return -1;
+		loop->heap = n_heap;
+		loop->heap_cap = n_cap;
+	}
+
+	size_t i = loop->heap_ctr++;
+	while (i && loop->heap[(i - 1) / 2].deadline > timer.deadline) {
+		loop->heap[i] = loop->heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+
+	loop->heap[i] = timer;
+	return 0;
+}
+
+// Remove the earliest deadline, sifting the last one down the heap.
+static void ev_heap_pop(EvLoop *loop) {
+	EvTimer last = loop->heap[--loop->heap_ctr];
+	size_t i = 0;
+
+	for (;;) {
+		size_t child = i * 2 + 1;
+
+		if (child >= loop->heap_ctr)
+			break;
+		if (child + 1 < loop->heap_ctr && loop->heap[child + 1].deadline < loop->heap[child].deadline)
+			child++;
+		if (last.deadline <= loop->heap[child].deadline)
+			break;
+
+		loop->heap[i] = loop->heap[child];
+		i = child;
+	}
+
+	if (loop->heap_ctr)
+		loop->heap[i] = last;
+}
+
+// Stop watching and close a descriptor of a session.
+static void ev_unwatch(EvLoop *loop, EvSession *ses, int which) {
+	if (ses->fds[which] == -1)
+		return;
+
+	epoll_ctl(loop->epfd, EPOLL_CTL_DEL, ses->fds[which], NULL);
+	close(ses->fds[which]);
+	ses->fds[which] = -1;
+}
+
+// Watch a descriptor of a session, closing it if it can't be.
+static void ev_watch(EvLoop *loop, size_t slot, int which, int fd) {
+	struct epoll_event ev;
+
+	ev.events = EPOLLIN;
+	ev.data.u64 = (uint64_t) slot * 4 + which;
+	loop->slots[slot].fds[which] = fd;
+
+	if (fd != -1 && epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+		close(fd);
+		loop->slots[slot].fds[which] = -1;
+	}
+}
+
+// Reap the command of a session, if block is unset only if it already exited.
+static void ev_reap(EvSession *ses, int block) {
+	int status = 0;
+	pid_t ret;
+
+	while ((ret = waitpid(ses->pid, &status, block ? 0 : WNOHANG)) == -1 && errno == EINTR)
+		;
+
+	if (ret == ses->pid)
+		ses->status = ev_exit_status(status);
+	else if (ret == -1)
+		ses->status = -1;
+}
+
+// Start the current command of a session. Return 0 if successful otherwise -1.
+static int ev_start_cmd(EvLoop *loop, size_t slot) {
+	EvSession *ses = &loop->slots[slot];
+	TransportProc proc;
+
+	ses->host->cmd_ctr++;
+	ses->seq++;
+	ses->timed_out = 0;
+
+	if (loop->transport->start(ses->session, loop->cmds[ses->cmd], &proc) == -1)
+		return -1;
+
+	ses->pid = proc.pid;
+	ses->status = EV_RUNNING;
+	ev_watch(loop, slot, EV_OUT, proc.out);
+	ev_watch(loop, slot, EV_ERR, proc.err);
+	ev_watch(loop, slot, EV_PID, ev_pidfd(proc.pid));
+
+	if (loop->timeout_ms) {
+		EvTimer timer = { ev_now() + loop->timeout_ms * 1000000ull, slot, ses->seq };
+
+		if (ev_heap_push(loop, timer) == 0 && loop->heap[0].seq == timer.seq && loop->heap[0].slot == slot)
+			ev_arm(loop);
+	}
+
+	return 0;
+}
+
+// Finish the host of a session.
+static void ev_finish_host(EvSession *ses) {
+	ses->host->secs = (ev_now() - ses->started) / 1e9;
+	Transport_close(ses->session);
+	ses->session = NULL;
+	ses->host = NULL;
+}
+
+// Start the next host in a slot, skipping hosts which fail straight away.
+// Return 1 if a host is running in the slot otherwise 0.
+static int ev_start_host(EvLoop *loop, size_t slot) {
+	EvSession *ses = &loop->slots[slot];
+
+	while (loop->next_host < loop->host_ctr) {
+		ses->host = &loop->hosts[loop->next_host++];
+		ses->started = ev_now();
+		ses->cmd = 0;
+		ses->session = Transport_open(loop->transport, ses->host->host);
+
+		if (!ses->session) {
+			ses->host->res.status = -1;
+			ev_finish_host(ses);
+			continue;
+		}
+
+		// An empty group succeeds.
+		if (!loop->cmd_ctr) {
+			ses->host->res.status = 0;
+			ev_finish_host(ses);
+			continue;
+		}
+
+		if (ev_start_cmd(loop, slot) == 0)
+			return 1;
+
+		ses->host->res.status = -1;
+		ev_finish_host(ses);
+	}
+
+	return 0;
+}
+
+// Move a session on once its command exited and its pipes closed, to the
+// next command or, if it failed or was the last, to the next host.
+static void ev_check(EvLoop *loop, size_t slot) {
+	EvSession *ses = &loop->slots[slot];
+
+	if (!ses->host || ses->fds[EV_OUT] != -1 || ses->fds[EV_ERR] != -1)
+		return;
+
+	// Without a pidfd the command is only waited for once its pipes closed.
+	if (ses->status == EV_RUNNING && ses->fds[EV_PID] == -1)
+		ev_reap(ses, 1);
+	if (ses->status == EV_RUNNING)
+		return;
+
+	ev_unwatch(loop, ses, EV_PID);
+	ses->host->res.status = ses->timed_out ? EVLOOP_TIMEOUT_STATUS : ses->status;
+
+	while (ses->host->res.status == 0 && ++ses->cmd < loop->cmd_ctr) {
+		if (ev_start_cmd(loop, slot) == 0)
+			return;
+		ses->host->res.status = -1;
+	}
+
+	ev_finish_host(ses);
+	if (!ev_start_host(loop, slot))
+		loop->active--;
+}
+
+// Read what is available on a pipe of a session into its output.
+// Return 0 once at end of file, 1 if more may follow.
+static int ev_drain(EvSession *ses, int which) {
+	VRope *rope = which == EV_OUT ? &ses->host->res.out : &ses->host->res.err;
+	size_t avail;
+	char *buff = VRope_spare(rope, 1, &avail);
+
+	if (!buff)
+		return 0;
+
+	ssize_t n = read(ses->fds[which], buff, avail);
+	if (n > 0) {
+		VRope_commit(rope, n);
+		return 1;
+	}
+
+	return n == -1 && (errno == EAGAIN || errno == EINTR);
+}
+
+// Kill the commands which ran past their deadline.
+static void ev_expire(EvLoop *loop) {
+	unsigned long long expirations;
+	unsigned long long now = ev_now();
+
+	// Only drains the timer, deadlines are checked against the clock.
+	if (read(loop->tfd, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN)
+		return;
+
+	while (loop->heap_ctr && loop->heap[0].deadline <= now) {
+		EvTimer timer = loop->heap[0];
+		EvSession *ses = &loop->slots[timer.slot];
+
+		ev_heap_pop(loop);
+		// The slot only moves on once the command exited and its pipes closed, so a
+		// reaped command whose background children still hold the pipes is killed too.
+		if (ses->host && ses->seq == timer.seq) {
+			// The command leads its own process group, so whatever it started dies too.
+			kill(-ses->pid, SIGKILL);
+			ses->timed_out = 1;
+		}
+	}
+
+	ev_arm(loop);
+}
+
+// Kill and reap whatever is still running, only when giving up early.
+static void ev_abort(EvLoop *loop) {
+	for (size_t slot = 0; slot < loop->slot_ctr; slot++) {
+		EvSession *ses = &loop->slots[slot];
+
+		if (!ses->host)
+			continue;
+
+		if (ses->status == EV_RUNNING) {
+			kill(-ses->pid, SIGKILL);
+			ev_reap(ses, 1);
+		}
+
+		for (int which = 0; which < 3; which++)
+			ev_unwatch(loop, ses, which);
+		ses->host->res.status = -1;
+		ev_finish_host(ses);
+	}
+}
+
+int EvLoop_run(Transport *transport, char **cmds, size_t cmd_ctr, HostResult *hosts,
+				size_t host_ctr, size_t max_active, unsigned int timeout_ms) {
+	if (null_check(transport, "evloop run") || !transport->start || (!cmds && cmd_ctr) || (!hosts && host_ctr))
+		return -1;
+
+	if (!host_ctr)
+		return 0;
+
+	// Hosts past what the descriptor limit allows would only fail to start.
+	struct rlimit lim;
+	if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur != RLIM_INFINITY) {
+		size_t fit = lim.rlim_cur > EV_RESERVED_FDS ? (lim.rlim_cur - EV_RESERVED_FDS) / EV_HOST_FDS : 0;
+
+		if (max_active > fit)
+			max_active = fit;
+	}
+
+	if (!max_active)
+		max_active = 1;
+	if (max_active > host_ctr)
+		max_active = host_ctr;
+
+	EvLoop loop = { -1, -1, transport, cmds, cmd_ctr, hosts, host_ctr, 0, NULL, max_active, 0, NULL, 0, 0, timeout_ms };
+	struct epoll_event events[EV_EVENTS];
+	struct epoll_event ev;
+	int ret = 0;
+
+	loop.epfd = epoll_create1(EPOLL_CLOEXEC);
+	loop.tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+	loop.slots = calloc(max_active, sizeof(EvSession));
+
+	ev.events = EPOLLIN;
+	ev.data.u64 = EV_TIMER_TAG;
+
+	if (loop.epfd == -1 || loop.tfd == -1 || null_check(loop.slots, "evloop run")
+		|| epoll_ctl(loop.epfd, EPOLL_CTL_ADD, loop.tfd, &ev) == -1) {
+		ret = -1;
+		loop.slot_ctr = 0;
+	}
+
+	for (size_t slot = 0; slot < loop.slot_ctr; slot++) {
+		EvSession *ses = &loop.slots[slot];
+
+		ses->fds[EV_OUT] = ses->fds[EV_ERR] = ses->fds[EV_PID] = -1;
+		ses->pid = -1;
+		ses->status = EV_RUNNING;
+		if (ev_start_host(&loop, slot))
+			loop.active++;
+	}
+
+	while (loop.active) {
+		int n = epoll_wait(loop.epfd, events, EV_EVENTS, -1);
+
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			ev_abort(&loop);
+			ret = -1;
+			break;
+		}
+
+		for (int i = 0; i < n; i++) {
+			if (events[i].data.u64 == EV_TIMER_TAG) {
+				ev_expire(&loop);
+				continue;
+			}
+
+			// Earlier events may have moved the slot on to another command already,
+			// which is harmless as every descriptor is non blocking.
+			size_t slot = events[i].data.u64 / 4;
+			int which = events[i].data.u64 % 4;
+			EvSession *ses = &loop.slots[slot];
+
+			if (!ses->host || ses->fds[which] == -1)
+				continue;
+
+			if (which == EV_PID) {
+				ev_reap(ses, 0);
+				if (ses->status != EV_RUNNING)
+					ev_unwatch(&loop, ses, EV_PID);
+			}
+			else if (!ev_drain(ses, which)) {
+				ev_unwatch(&loop, ses, which);
+			}
+
+			ev_check(&loop, slot);
+		}
+	}
+
+	// Hosts never started when the loop could not be set up.
+	for (; loop.next_host < host_ctr; loop.next_host++)
+		hosts[loop.next_host].res.status = -1;
+
+	if (loop.epfd != -1)
+		close(loop.epfd);
+	if (loop.tfd != -1)
+		close(loop.tfd);
+	free(loop.slots);
+	free(loop.heap);
+	return ret;
+}
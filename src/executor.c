@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "executor.h"
+#include "evloop.h"
+#include "utils.h"
+
+#define ERR_HOST_OPEN 0
+#define ERR_HOST_CMD 1
+
+static const char *Error_Templates[] = {
+	"Group {%s} could not connect to %s",
+	"Group {%s} command \"%s\" failed with status %d on %s"
+};
+
+/**
+ * @brief Group run on threads, shared by the tasks of its hosts.
+ *
+ * errors holds the Error of each host's copy of the NexecMgr until
+ * they are moved to the parent in host order.
+ */
+typedef struct {
+	NexecMgr *nexec_mgr;
+	FlatIdx group;
+	HostResult *results;
+	Error **errors;
+} HostJob;
+
+/**
+ * @brief Task running a single host of a group.
+ */
+typedef struct {
+	HostJob *job;
+	size_t idx;
+} HostTask;
+
+// Monotonic clock in seconds.
+static double executor_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Report a group failing on a host, cmd being the command which failed or NULL if it could not connect.
+static void executor_error(Error *err_handle, const char *name, HostResult *host, const char *cmd) {
+	VString msg = VString_new();
+	VString *ok = cmd
+		? VString_pushf(&msg, Error_Templates[ERR_HOST_CMD], name, cmd, host->res.status, host->host)
+		: VString_pushf(&msg, Error_Templates[ERR_HOST_OPEN], name, host->host);
+
+	// Errors past the capacity of the handle are dropped.
+	if (ok && err_handle && err_handle->error_ctr < err_handle->error_cap)
+		Error_add(err_handle, string_dup(VString_str(&msg)));
+	VString_free(&msg);
+}
+
+int Executor_run_host(NexecMgr *nexec_mgr, FlatIdx group, HostResult *host) {
+	if (null_check(nexec_mgr, "executor run host") || null_check(host, "executor run host")) return -1;
+
+	FlatAst *ast = nexec_mgr->ast;
+	char *name = FlatAst_value(ast, group);
+	double started = executor_now();
+	int ret = 0;
+
+	TransportSession *session = Transport_open(nexec_mgr->transport, host->host);
+	if (!session) {
+		host->res.status = -1;
+		host->secs = executor_now() - started;
+		executor_error(nexec_mgr->err_handle, name, host, NULL);
+		return -1;
+	}
+	session->timeout_ms = nexec_mgr->timeout_ms;
+
+	// Commands are the kids of the group, run in order until one fails.
+	for (size_t i = 0; i < ast->rhs[group] && !ret; i++) {
+		char *cmd = FlatAst_value(ast, ast->kids[ast->lhs[group] + i]);
+
+		Transport_run(session, cmd, &host->res);
+		host->cmd_ctr++;
+
+		if (host->res.status != 0) {
+			executor_error(nexec_mgr->err_handle, name, host, cmd);
+			ret = -1;
+		}
+	}
+
+	// An empty group succeeds.
+	if (!host->cmd_ctr)
+		host->res.status = 0;
+
+	Transport_close(session);
+	host->secs = executor_now() - started;
+	return ret;
+}
+
+// Run a host on its own copy of the NexecMgr, on a pool worker or the calling thread.
+static void executor_task(void *arg, size_t worker) {
+	HostTask *task = arg;
+	HostJob *job = task->job;
+	NexecMgr *fork = Nexec_fork(job->nexec_mgr);
+
+	(void) worker;
+	if (!fork)
+		return;
+
+	Executor_run_host(fork, job->group, &job->results[task->idx]);
+
+	// Errors outlive the copy, they are moved to the parent once every host is done.
+	job->errors[task->idx] = fork->err_handle;
+	fork->err_handle = NULL;
+	NexecMgr_free(fork);
+}
+
+// Move the errors of a host to the parent, dropping those it has no room for.
+static void executor_move_errors(Error *parent, Error *errors) {
+	if (!errors)
+		return;
+
+	for (size_t i = 0; i < errors->error_ctr; i++) {
+		if (!parent || parent->error_ctr == parent->error_cap)
+			free(errors->errors[i]);
+		else
+			Error_add(parent, errors->errors[i]);
+	}
+
+	errors->error_ctr = 0;
+	Error_free(errors);
+}
+
+// Run hosts as tasks of the pool, started with forks workers on the first group
+// run on threads and kept for the rest.
+static int executor_run_threads(NexecMgr *nexec_mgr, FlatIdx group, HostResult *hosts, size_t host_ctr) {
+	Error **errors = calloc(host_ctr + 1, sizeof(Error *));
+	HostTask *tasks = malloc((host_ctr + 1) * sizeof(HostTask));
+
+	if (null_check(errors, "executor run threads") || null_check(tasks, "executor run threads")) {
+		free(errors);
+		free(tasks);
+		return -1;
+	}
+
+	if (!nexec_mgr->pool && nexec_mgr->forks > 1)
+		nexec_mgr->pool = TaskPool_new(nexec_mgr->forks);
+
+	HostJob job = { nexec_mgr, group, hosts, errors };
+
+	// Without a pool, or if it has no room left, hosts run on the calling thread.
+	for (size_t i = 0; i < host_ctr; i++) {
+		tasks[i] = (HostTask) { &job, i };
+		if (!nexec_mgr->pool || TaskPool_submit(nexec_mgr->pool, executor_task, &tasks[i]) == -1)
+			executor_task(&tasks[i], 0);
+	}
+
+	TaskPool_wait(nexec_mgr->pool);
+
+	for (size_t i = 0; i < host_ctr; i++)
+		executor_move_errors(nexec_mgr->err_handle, errors[i]);
+
+	free(errors);
+	free(tasks);
+	return 0;
+}
+
+// Run hosts on the event loop, up to forks at once, reporting failures once all are done.
+static int executor_run_loop(NexecMgr *nexec_mgr, FlatIdx group, HostResult *hosts, size_t host_ctr) {
+	FlatAst *ast = nexec_mgr->ast;
+	char *name = FlatAst_value(ast, group);
+	size_t cmd_ctr = ast->rhs[group];
+	char **cmds = malloc((cmd_ctr + 1) * sizeof(char *));
+
+	if (null_check(cmds, "executor run loop"))
+		return -1;
+
+	for (size_t i = 0; i < cmd_ctr; i++)
+		cmds[i] = FlatAst_value(ast, ast->kids[ast->lhs[group] + i]);
+
+	int ret = EvLoop_run(nexec_mgr->transport, cmds, cmd_ctr, hosts, host_ctr,
+						nexec_mgr->forks, nexec_mgr->timeout_ms);
+
+	// A host failing before any command ran could not connect.
+	for (size_t i = 0; ret == 0 && i < host_ctr; i++) {
+		HostResult *host = &hosts[i];
+
+		if (host->res.status != 0)
+			executor_error(nexec_mgr->err_handle, name, host, host->cmd_ctr ? cmds[host->cmd_ctr - 1] : NULL);
+	}
+
+	free(cmds);
+	return ret;
+}
+
+int Executor_run_hosts(NexecMgr *nexec_mgr, FlatIdx group, HostResult *hosts, size_t host_ctr) {
+	if (null_check(nexec_mgr, "executor run hosts") || null_check(nexec_mgr->transport, "executor run hosts")
+		|| (host_ctr && null_check(hosts, "executor run hosts"))) return -1;
+
+	// Transports which can start commands without waiting for them share one thread.
+	if (nexec_mgr->transport->start)
+		return executor_run_loop(nexec_mgr, group, hosts, host_ctr);
+	return executor_run_threads(nexec_mgr, group, hosts, host_ctr);
+}
+
+HostResult *Executor_run_group(NexecMgr *nexec_mgr, FlatIdx group) {
+	if (null_check(nexec_mgr, "executor run group") || null_check(nexec_mgr->inventory, "executor run group")) return NULL;
+
+	Inventory *inv = nexec_mgr->inventory;
+	HostResult *results = calloc(inv->host_ctr + 1, sizeof(HostResult));
+
+	if (null_check(results, "executor run group"))
+		return NULL;
+
+	for (size_t i = 0; i < inv->host_ctr; i++) {
+		results[i].host = inv->hosts[i];
+		results[i].res = TransportResult_new();
+	}
+
+	if (Executor_run_hosts(nexec_mgr, group, results, inv->host_ctr) == -1) {
+		Executor_free_results(results, inv->host_ctr);
+		return NULL;
+	}
+
+	return results;
+}
+
+void Executor_report(HostResult *results, size_t n, FILE *out, FILE *err) {
+	if (!results) return;
+
+	for (size_t i = 0; i < n; i++) {
+		HostResult *host = &results[i];
+
+		if (host->res.status == 0)
+			fprintf(out, "%s | ok\n", host->host);
+		else
+			fprintf(out, "%s | failed (%d)\n", host->host, host->res.status);
+
+		// Keep each host's stderr after its stdout when both go to a terminal.
+		VRope_fwrite(&host->res.out, out);
+		fflush(out);
+		VRope_fwrite(&host->res.err, err);
+	}
+}
+
+void Executor_free_results(HostResult *results, size_t n) {
+	if (!results) return;
+
+	for (size_t i = 0; i < n; i++)
+		TransportResult_free(&results[i].res);
+	free(results);
+}
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flatast.h"
+#include "utils.h"
+
+/**
+ * @brief State used while lowering, remap maps a pool id to its index in strs.
+ */
+typedef struct {
+	FlatAst *ast;
+	InternPool *pool;
+	unsigned int *remap;
+	int failed;
+} FlatLower;
+
+static FlatIdx flat_lower(FlatLower *fl, Node *node);
+
+// Grow an array to hold at least ctr + 1 elements.
+static void *flat_reserve(FlatLower *fl, void *arr, size_t ctr, size_t *cap, size_t elem) {
+	if (ctr < *cap)
+		return arr;
+
+	size_t cap_new = *cap ? *cap * 2 : 64;
+	void *arr_new = realloc(arr, cap_new * elem);
+
+	if (!arr_new) {
+		fl->failed = 1;
+		return arr;
+	}
+
+	*cap = cap_new;
+	return arr_new;
+}
+
+// Add value to the string table, returns its index.
+static unsigned int flat_put_string(FlatLower *fl, char *str) {
+	FlatAst *ast = fl->ast;
+	unsigned int id = 0;
+
+	if (!str)
+		return FLAT_NONE;
+
+	if (InternPool_find(fl->pool, str, strlen(str), &id)) {
+		fl->failed = 1;
+		return FLAT_NONE;
+	}
+
+	if (fl->remap[id] != FLAT_NONE)
+		return fl->remap[id];
+
+	ast->strs = flat_reserve(fl, ast->strs, ast->str_ctr, &ast->str_cap, sizeof(char *));
+	if (fl->failed)
+		return FLAT_NONE;
+
+	ast->strs[ast->str_ctr] = InternPool_get(fl->pool, id);
+	fl->remap[id] = ast->str_ctr;
+	return ast->str_ctr++;
+}
+
+// Append a node once its operands are known.
+static FlatIdx flat_put_node(FlatLower *fl, Node *node, FlatIdx lhs, FlatIdx rhs) {
+	FlatAst *ast = fl->ast;
+	unsigned int value = flat_put_string(fl, node->value);
+
+	if (ast->node_ctr == ast->node_cap) {
+		size_t cap = ast->node_cap ? ast->node_cap * 2 : 256;
+		unsigned char *types = realloc(ast->types, cap);
+		unsigned char *kwids = types ? realloc(ast->kwids, cap) : NULL;
+		unsigned int *values = kwids ? realloc(ast->values, cap * sizeof(unsigned int)) : NULL;
+		FlatIdx *lhs_new = values ? realloc(ast->lhs, cap * sizeof(FlatIdx)) : NULL;
+		FlatIdx *rhs_new = lhs_new ? realloc(ast->rhs, cap * sizeof(FlatIdx)) : NULL;
+
+		// Keep whatever did move so nothing leaks.
+		if (types) ast->types = types;
+		if (kwids) ast->kwids = kwids;
+		if (values) ast->values = values;
+		if (lhs_new) ast->lhs = lhs_new;
+		if (rhs_new) ast->rhs = rhs_new;
+
+		if (!rhs_new || cap >= FLAT_NONE) {
+			fl->failed = 1;
+			return FLAT_NONE;
+		}
+		ast->node_cap = cap;
+	}
+
+	ast->types[ast->node_ctr] = node->type;
+	ast->kwids[ast->node_ctr] = node->kwid;
+	ast->values[ast->node_ctr] = value;
+	ast->lhs[ast->node_ctr] = lhs;
+	ast->rhs[ast->node_ctr] = rhs;
+	return ast->node_ctr++;
+}
+
+// Lower a list of children into kids, children first then the list itself.
+static FlatIdx flat_lower_list(FlatLower *fl, Node *node, Node **items, size_t item_ctr) {
+	FlatAst *ast = fl->ast;
+	FlatIdx *list = malloc((item_ctr + 1) * sizeof(FlatIdx));
+
+	if (!list) {
+		fl->failed = 1;
+		return FLAT_NONE;
+	}
+
+	for (size_t i = 0; i < item_ctr; i++)
+		list[i] = flat_lower(fl, items[i]);
+
+	FlatIdx first = ast->kid_ctr;
+	for (size_t i = 0; i < item_ctr && !fl->failed; i++) {
+		ast->kids = flat_reserve(fl, ast->kids, ast->kid_ctr, &ast->kid_cap, sizeof(FlatIdx));
+		if (!fl->failed)
+			ast->kids[ast->kid_ctr++] = list[i];
+	}
+
+	free(list);
+	return flat_put_node(fl, node, first, item_ctr);
+}
+
+// Lower a tree rooted at node, returns its index.
+static FlatIdx flat_lower(FlatLower *fl, Node *node) {
+	FlatIdx lhs = FLAT_NONE;
+	FlatIdx rhs = FLAT_NONE;
+
+	if (!node || fl->failed) {
+		fl->failed = 1;
+		return FLAT_NONE;
+	}
+
+	if (node->type == E_EQUAL_NODE || FlatAst_is_binop(node->type) || FlatAst_is_compare(node->type)) {
+		lhs = flat_lower(fl, node->data->BinExpNode.left);
+		rhs = flat_lower(fl, node->data->BinExpNode.right);
+	}
+	else if (node->type == E_FUNC_NODE) {
+		lhs = flat_lower(fl, node->data->FuncNode.args);
+	}
+	else if (node->type == E_ARRAY_NODE) {
+		return flat_lower_list(fl, node, node->data->ArrayNode.items, node->data->ArrayNode.dctr);
+	}
+	else if (node->type == E_GROUP_NODE) {
+		size_t cmd_ctr = 0;
+		Node *itr = node->data->GroupNode.next;
+
+		// Commands form a circular list back to the group, collect them first.
+		for (; itr && itr != node; itr = itr->data->GroupNode.next)
+			cmd_ctr++;
+
+		Node **cmds = malloc((cmd_ctr + 1) * sizeof(Node *));
+		if (!cmds) {
+			fl->failed = 1;
+			return FLAT_NONE;
+		}
+
+		cmd_ctr = 0;
+		for (itr = node->data->GroupNode.next; itr && itr != node; itr = itr->data->GroupNode.next)
+			cmds[cmd_ctr++] = itr;
+
+		// Commands only carry their link in data, lowered they are plain strings.
+		FlatIdx idx = flat_lower_list(fl, node, cmds, cmd_ctr);
+		free(cmds);
+		return idx;
+	}
+
+	return flat_put_node(fl, node, lhs, rhs);
+}
+
+FlatAst *FlatAst_new(void) {
+	FlatAst *ast = calloc(1, sizeof(FlatAst));
+	return ast;
+}
+
+// Resolve identifiers to the slots of their symbols, labels are found through the remap.
+static void flat_resolve(FlatLower *fl, SyTable *sy_table) {
+	FlatAst *ast = fl->ast;
+	unsigned int *str_slots = malloc((ast->str_ctr + 1) * sizeof(unsigned int));
+	unsigned int id = 0;
+
+	if (!str_slots) {
+		fl->failed = 1;
+		return;
+	}
+
+	memset(str_slots, 0xff, (ast->str_ctr + 1) * sizeof(unsigned int));
+
+	// Labels not used by any node have no index in strs.
+	for (size_t s = 0; s < sy_table->sym_ctr; s++) {
+		char *label = sy_table->symbols[s]->label;
+		if (!InternPool_find(fl->pool, label, strlen(label), &id) && fl->remap[id] != FLAT_NONE)
+			str_slots[fl->remap[id]] = s;
+	}
+
+	for (size_t i = 0; i < ast->node_ctr; i++) {
+		if (FlatAst_type(ast, i) == E_IDENTIFIER_NODE)
+			ast->rhs[i] = str_slots[ast->values[i]];
+	}
+
+	free(str_slots);
+}
+
+int FlatAst_lower(FlatAst *ast, NodeMgr *node_mgr, SyTable *sy_table) {
+	if (null_check(ast, "flatast lower") || null_check(node_mgr, "flatast lower") || null_check(sy_table, "flatast lower"))
+		return -1;
+
+	InternPool *pool = sy_table->pool;
+
+	// Borrowed arrays can't grow.
+	if (ast->borrowed)
+		return -1;
+
+	FlatLower fl = { ast, pool, malloc((pool->str_ctr + 1) * sizeof(unsigned int)), 0 };
+
+	if (null_check(fl.remap, "flatast lower"))
+		return -1;
+
+	memset(fl.remap, 0xff, (pool->str_ctr + 1) * sizeof(unsigned int));
+
+	for (size_t i = 0; i < node_mgr->nodes_ctr && !fl.failed; i++) {
+		FlatIdx root = flat_lower(&fl, node_mgr->nodes[i]);
+		ast->roots = flat_reserve(&fl, ast->roots, ast->root_ctr, &ast->root_cap, sizeof(FlatIdx));
+		if (!fl.failed)
+			ast->roots[ast->root_ctr++] = root;
+	}
+
+	if (!fl.failed)
+		flat_resolve(&fl, sy_table);
+
+	free(fl.remap);
+	return fl.failed ? -1 : 0;
+}
+
+void FlatAst_free(FlatAst *ast) {
+	if (null_check(ast, "flatast free")) return;
+
+	if (!ast->borrowed) {
+		free(ast->types);
+		free(ast->kwids);
+		free(ast->values);
+		free(ast->lhs);
+		free(ast->rhs);
+		free(ast->kids);
+		free(ast->roots);
+	}
+
+	free(ast->strs);
+	free(ast);
+}
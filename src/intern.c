@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+#include "utils.h"
+
+// Locate slot for string, either holding it or the empty slot where it belongs.
+static size_t intern_probe(InternPool *pool, const char *str, size_t len, unsigned int hash) {
+	size_t mask = pool->slot_cap - 1;
+	size_t slot = hash & mask;
+	unsigned int id;
+
+	while ((id = pool->slots[slot].id)) {
+		id--;
+		if (pool->slots[slot].hash == hash && pool->lens[id] == len && memcmp(pool->strs[id], str, len) == 0)
+			break;
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+// Double slot table and rehash existing strings using their stored hash.
+static int intern_grow_slots(InternPool *pool) {
+	size_t n_cap = pool->slot_cap * 2;
+	InternSlot *n_slots = calloc(n_cap, sizeof(InternSlot));
+
+	if (!n_slots)
+		return -1;
+
+	for (size_t i = 0; i < pool->slot_cap; i++) {
+		if (!pool->slots[i].id)
+			continue;
+		size_t slot = pool->slots[i].hash & (n_cap - 1);
+		while (n_slots[slot].id)
+			slot = (slot + 1) & (n_cap - 1);
+		n_slots[slot] = pool->slots[i];
+	}
+
+	free(pool->slots);
+	pool->slots = n_slots;
+	pool->slot_cap = n_cap;
+	return 0;
+}
+
+// Grow per id arrays.
+static int intern_grow_strs(InternPool *pool) {
+	size_t n_cap = pool->str_cap * 2;
+	char **n_strs = realloc(pool->strs, n_cap * sizeof(char *));
+	unsigned int *n_lens = realloc(pool->lens, n_cap * sizeof(unsigned int));
+
+	if (n_strs) pool->strs = n_strs;
+	if (n_lens) pool->lens = n_lens;
+
+	if (!n_strs || !n_lens)
+		return -1;
+
+	pool->str_cap = n_cap;
+	return 0;
+}
+
+InternPool *InternPool_new(void) {
+	InternPool *pool = malloc(sizeof(InternPool));
+	pool->arena = Arena_new(0);
+	pool->str_ctr = 0;
+	pool->str_cap = INIT_INTERN_SIZE;
+	pool->strs = malloc(pool->str_cap * sizeof(char *));
+	pool->lens = malloc(pool->str_cap * sizeof(unsigned int));
+	pool->slot_cap = INIT_INTERN_SIZE * 2;
+	pool->slots = calloc(pool->slot_cap, sizeof(InternSlot));
+	return pool;
+}
+
+void InternPool_free(InternPool *pool) {
+	if (null_check(pool, "intern free")) return;
+
+	Arena_free(pool->arena);
+	free(pool->strs);
+	free(pool->lens);
+	free(pool->slots);
+	free(pool);
+}
+
+// Insert string, copying it into the arena unless told it is static.
+// Return its id or INTERN_ERROR_ID if failed, leaving the pool as it was.
+static unsigned int intern_insert(InternPool *pool, const char *str, size_t len, int is_static) {
+	unsigned int hash = string_hash(str, len);
+	size_t slot = intern_probe(pool, str, len, hash);
+
+	if (pool->slots[slot].id)
+		return pool->slots[slot].id - 1;
+
+	// Keep load factor at or below a half.
+	if ((pool->str_ctr + 1) * 2 > pool->slot_cap) {
+		if (intern_grow_slots(pool) == -1)
+			return INTERN_ERROR_ID;
+		slot = intern_probe(pool, str, len, hash);
+	}
+
+	if (pool->str_ctr == pool->str_cap && intern_grow_strs(pool) == -1)
+		return INTERN_ERROR_ID;
+
+	char *copy = (char *) str;
+
+	if (!is_static) {
+		copy = Arena_alloc_bytes(pool->arena, len + 1);
+		if (!copy)
+			return INTERN_ERROR_ID;
+		memcpy(copy, str, len);
+		copy[len] = '\0';
+	}
+
+	unsigned int id = pool->str_ctr++;
+
+	pool->strs[id] = copy;
+	pool->lens[id] = len;
+	pool->slots[slot].hash = hash;
+	pool->slots[slot].id = id + 1;
+	return id;
+}
+
+unsigned int InternPool_add(InternPool *pool, const char *str, size_t len) {
+	return intern_insert(pool, str, len, 0);
+}
+
+unsigned int InternPool_add_static(InternPool *pool, const char *str, size_t len) {
+	return intern_insert(pool, str, len, 1);
+}
+
+char *InternPool_intern(InternPool *pool, const char *str, size_t len) {
+	if (null_check(pool, "intern") || !str) return NULL;
+
+	// Adding may grow strs, so it has to happen before indexing.
+	unsigned int id = InternPool_add(pool, str, len);
+	return id == INTERN_ERROR_ID ? NULL : pool->strs[id];
+}
+
+char *InternPool_lookup(InternPool *pool, const char *str, size_t len) {
+	if (null_check(pool, "intern lookup") || !str) return NULL;
+
+	size_t slot = intern_probe(pool, str, len, string_hash(str, len));
+	return pool->slots[slot].id ? pool->strs[pool->slots[slot].id - 1] : NULL;
+}
+
+int InternPool_find(InternPool *pool, const char *str, size_t len, unsigned int *id) {
+	if (null_check(pool, "intern find") || !str) return -1;
+
+	size_t slot = intern_probe(pool, str, len, string_hash(str, len));
+	if (!pool->slots[slot].id)
+		return -1;
+
+	*id = pool->slots[slot].id - 1;
+	return 0;
+}
+
+char *InternPool_get(InternPool *pool, unsigned int id) {
+	if (null_check(pool, "intern get") || id >= pool->str_ctr) return NULL;
+	return pool->strs[id];
+}
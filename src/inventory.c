@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "inventory.h"
+#include "utils.h"
+
+#define INIT_INVENTORY_SIZE 16
+
+Inventory *Inventory_new(void) {
+	Inventory *inv = calloc(1, sizeof(Inventory));
+	return inv;
+}
+
+int Inventory_add(Inventory *inv, const char *host, size_t len) {
+	if (null_check(inv, "inventory add") || null_check((void *) host, "inventory add")) return -1;
+
+	if (inv->host_ctr == inv->host_cap) {
+		size_t n_cap = inv->host_cap ? inv->host_cap * 2 : INIT_INVENTORY_SIZE;
+		char **n_hosts = realloc(inv->hosts, n_cap * sizeof(char *));
+
+		if (null_check(n_hosts, "inventory add"))
+			return -1;
+		inv->hosts = n_hosts;
+		inv->host_cap = n_cap;
+	}
+
+	char *copy = malloc(len + 1);
+	if (null_check(copy, "inventory add"))
+		return -1;
+
+	memcpy(copy, host, len);
+	copy[len] = '\0';
+	inv->hosts[inv->host_ctr++] = copy;
+	return 0;
+}
+
+int Inventory_load(Inventory *inv, const char *path) {
+	if (null_check(inv, "inventory load")) return -1;
+
+	SrcFile *src = SrcFile_open(path);
+	size_t added = 0;
+
+	if (!src)
+		return -1;
+
+	for (size_t pos = 0; pos < src->len; ) {
+		const char *line = src->buff + pos;
+		const char *nl = memchr(line, '\n', src->len - pos);
+		size_t len = nl ? (size_t) (nl - line) : src->len - pos;
+
+		pos += len + 1;
+
+		// Trim the line, skipping blank ones and comments.
+		while (len && isspace((unsigned char) *line)) {
+			line++;
+			len--;
+		}
+		while (len && isspace((unsigned char) line[len - 1]))
+			len--;
+
+		if (!len || *line == '#')
+			continue;
+
+		if (Inventory_add(inv, line, len) == -1) {
+			SrcFile_close(src);
+			return -1;
+		}
+		added++;
+	}
+
+	SrcFile_close(src);
+	return (int) added;
+}
+
+void Inventory_free(Inventory *inv) {
+	if (!inv) return;
+
+	for (size_t i = 0; i < inv->host_ctr; i++)
+		free(inv->hosts[i]);
+	free(inv->hosts);
+	free(inv);
+}
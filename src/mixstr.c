@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include <string.h>
+#include "mixstr.h"
+#include "tokens.h"
+#include "utils.h"
+
+// Append a segment, growing segs as needed.
+static int mixstr_push(MixStr *mstr, size_t *cap, MixSeg seg) {
+	if (mstr->seg_ctr == *cap) {
+		size_t n_cap = *cap ? *cap * 2 : 4;
+		MixSeg *n_segs = realloc(mstr->segs, n_cap * sizeof(MixSeg));
+
+		if (!n_segs)
+			return -1;
+		mstr->segs = n_segs;
+		*cap = n_cap;
+	}
+
+	mstr->segs[mstr->seg_ctr++] = seg;
+	return 0;
+}
+
+MixStr *MixStr_compile(char *mstr, SyTable *sy_table) {
+	if (null_check(mstr, "mixstr compile") || null_check(sy_table, "mixstr compile")) return NULL;
+
+	MixStr *out = calloc(1, sizeof(MixStr));
+	size_t cap = 0;
+	char *it = mstr;
+	char *var = NULL;
+	int failed = !out;
+
+	if (out)
+		out->src = mstr;
+
+	while (!failed && *it) {
+		var = strchr(it, VAR);
+
+		// Literal up to the next variable or the end.
+		size_t lit = var ? (size_t) (var - it) : strlen(it);
+		if (lit) {
+			failed = mixstr_push(out, &cap, (MixSeg) { it - mstr, lit, MIXSTR_NONE, NULL });
+			out->lit_len += lit;
+		}
+
+		if (failed || !var)
+			break;
+
+		// Variable name runs until the first character which isn't part of an identifier.
+		it = var + 1;
+		while (is_valid_identifier(*it))
+			it++;
+
+		MixSeg seg = { var - mstr, it - var, MIXSTR_NONE, NULL };
+		seg.name = InternPool_intern(sy_table->pool, var + 1, it - var - 1);
+		failed = !seg.name;
+
+		if (!failed)
+			SyTable_lookup_slot(sy_table, seg.name, &seg.slot);
+		if (!failed)
+			failed = mixstr_push(out, &cap, seg);
+		if (!failed)
+			out->var_ctr++;
+	}
+
+	if (failed) {
+		MixStr_free(out);
+		return NULL;
+	}
+
+	return out;
+}
+
+void MixStr_free(MixStr *mstr) {
+	if (!mstr) return;
+
+	free(mstr->segs);
+	free(mstr);
+}
@@ -1,131 +1,150 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "nexec.h"
+#include "executor.h"
 #include "utils.h"
 
 #define ERR_UNDEFINE_VAR 0
 
 static const char *Error_Templates[] = {
-	"Use of undefined variable '$@0' near @1"
+	"Use of undefined variable '$%s' near %s"
 };
 
 // Execute a string node.
-static char *exec_string(Node *node) {
-	return node->value;
+static char *exec_string(FlatAst *ast, FlatIdx node) {
+	return FlatAst_value(ast, node);
 }
 
-// Get the value of a variable stored in symbol table.
+// Get the value of the variable an identifier node resolved to.
 // Return NULL if it doesn't exist or undefined.
-static char *expand_variable(SyTable *sy_table, char *name) {
-	if (!name)
-		return NULL;
-		
-	Symbol *sy = SyTable_get_symbol(sy_table, name);
-	
-	if (!sy)
-		return NULL;
-		
-	return sy->val;
+static Value *expand_slot(NexecMgr *nexec_mgr, FlatIdx node) {
+	Symbol *sy = SyTable_get_slot(nexec_mgr->sy_table, nexec_mgr->ast->rhs[node]);
+	return sy && sy->val.type != E_NONE_VALUE ? &sy->val : NULL;
 }
 
-// Expand a mixed string and return malloc'ed value. 
-static char *exec_mixed_string(char *mstr, NexecMgr *nexec_mgr) {
-	VString_set(&nexec_mgr->buff, mstr);
+char *Nexec_mixed_string(NexecMgr *nexec_mgr, unsigned int str) {
+	MixStr *mstr = str < nexec_mgr->mixstr_ctr ? nexec_mgr->mixstrs[str] : NULL;
 
-	char *m_str_it = strchr(mstr, VAR);
+	if (!mstr)
+		return nexec_mgr->ast->strs[str];
 
-	// Proceed only if it has substitute char.
-	if (m_str_it) {
+	SyTable *sy_table = nexec_mgr->sy_table;
+	VString *buff = &nexec_mgr->buff;
+	size_t size = mstr->lit_len;
+	Symbol *sy;
+	Value *val;
+
+	// Size the result up front, numbers are given their widest length.
+	for (size_t i = 0; i < mstr->seg_ctr && mstr->var_ctr; i++) {
+		MixSeg *seg = &mstr->segs[i];
+		if (!seg->name)
+			continue;
+
+		sy = SyTable_get_slot(sy_table, seg->slot);
+		val = sy ? &sy->val : NULL;
+		if (!val || val->type == E_NONE_VALUE)
+			size += seg->length;
+		else if (val->type == E_STR_VALUE)
+			size += strlen(val->as.str);
+		else
+			size += 20;
+	}
 
-		// Temp buffer for var names.
-		VString buf = VString_new();
-		// Expanded variable.
-		char *var_val;
+	VString_clear(buff);
+	VString_reserve(buff, size);
 
-		while(m_str_it) {
+	for (size_t i = 0; i < mstr->seg_ctr; i++) {
+		MixSeg *seg = &mstr->segs[i];
+		char *seg_str = mstr->src + seg->offset;
 
-			// Add '$' to buffer and increment.	
-			VString_pushc(&buf, *m_str_it++);
-		
-			while(is_valid_identifier(*m_str_it)) {
-				VString_pushc(&buf, *m_str_it);
-				m_str_it++;
-			}
+		if (!seg->name) {
+			VString_pushn(buff, seg_str, seg->length);
+			continue;
+		}
 
-			var_val = expand_variable(nexec_mgr->sy_table, buf.str+1);
-			
-			// Only replace if valid variable.
-			if (!var_val) {
-				NexecMgr_add_error(nexec_mgr->err_handle, buf.str+1, nexec_mgr->curr_node->value);
-			}
-			else {
-				VString_replace(&nexec_mgr->buff, buf.str, var_val);
-			}
+		sy = SyTable_get_slot(sy_table, seg->slot);
+		val = sy ? &sy->val : NULL;
 
-			VString_set(&buf, "");
-			m_str_it = strchr(m_str_it, VAR);
+		// Only replace if valid variable.
+		if (!val || val->type == E_NONE_VALUE) {
+			NexecMgr_add_error(nexec_mgr->err_handle, seg->name, FlatAst_value(nexec_mgr->ast, nexec_mgr->curr));
+			VString_pushn(buff, seg_str, seg->length);
+		}
+		else if (val->type == E_STR_VALUE) {
+			VString_pushs(buff, val->as.str);
+		}
+		else if (val->type == E_ARRAY_VALUE) {
+			VString arr = VString_new();
+			VString_pushs(buff, Value_to_string(val, &arr));
+			VString_free(&arr);
+		}
+		else if (val->text) {
+			VString_pushs(buff, val->text);
+		}
+		else {
+			VString_pushf(buff, "%lld", val->as.num);
 		}
-		VString_free(&buf);
 	}
-	return nexec_mgr->buff.str;
+
+	return VString_str(buff);
 }
 
 // Execute a expression node (3 + 4).
-static int exec_expression(NexecMgr *nexec_mgr, Node *node) {
-	int ret = 0;
-	Symbol *sy;
+static long long exec_expression(NexecMgr *nexec_mgr, FlatIdx node) {
+	FlatAst *ast = nexec_mgr->ast;
+	char *value = NULL;
+	Value *val = NULL;
+	long long ret = 0;
 
-	switch(node->type) {
+	switch(FlatAst_type(ast, node)) {
 		case E_GREATERTHANEQ_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) >= exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = exec_expression(nexec_mgr, ast->lhs[node]) >= exec_expression(nexec_mgr, ast->rhs[node]);
 			break;
 		case E_GREATERTHAN_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) > exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = exec_expression(nexec_mgr, ast->lhs[node]) > exec_expression(nexec_mgr, ast->rhs[node]);
 			break;
 		case E_LESSTHANEQ_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) <= exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = exec_expression(nexec_mgr, ast->lhs[node]) <= exec_expression(nexec_mgr, ast->rhs[node]);
 			break;
 		case E_LESSTHAN_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) < exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = exec_expression(nexec_mgr, ast->lhs[node]) < exec_expression(nexec_mgr, ast->rhs[node]);
 			break;
 		case E_NEQUAL_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) != exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = exec_expression(nexec_mgr, ast->lhs[node]) != exec_expression(nexec_mgr, ast->rhs[node]);
 			break;
 		case E_EEQUAL_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) == exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = exec_expression(nexec_mgr, ast->lhs[node]) == exec_expression(nexec_mgr, ast->rhs[node]);
 			break;
 		case E_ADD_NODE: 
-			ret += exec_expression(nexec_mgr, node->data->BinExpNode.left) + exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = VALUE_WRAP(exec_expression(nexec_mgr, ast->lhs[node]), +, exec_expression(nexec_mgr, ast->rhs[node]));
 			break;
 		case E_MINUS_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) - exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = VALUE_WRAP(exec_expression(nexec_mgr, ast->lhs[node]), -, exec_expression(nexec_mgr, ast->rhs[node]));
 			break;
 		case E_DIV_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) / exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = Value_div(exec_expression(nexec_mgr, ast->lhs[node]), exec_expression(nexec_mgr, ast->rhs[node]));
 			break;
 		case E_TIMES_NODE:
-			ret = exec_expression(nexec_mgr, node->data->BinExpNode.left) *  exec_expression(nexec_mgr, node->data->BinExpNode.right);
+			ret = VALUE_WRAP(exec_expression(nexec_mgr, ast->lhs[node]), *, exec_expression(nexec_mgr, ast->rhs[node]));
 			break;
 		case E_INTEGER_NODE:
-			ret = string_to_int(node->value, strlen(node->value));
+			value = FlatAst_value(ast, node);
+			ret = string_to_int64(value, strlen(value));
 			break;
 		case E_STRING_NODE:
-			ret = string_to_ascii(node->value);
+			ret = string_to_ascii(FlatAst_value(ast, node));
 			break;
 		case E_MIXSTR_NODE:
-			exec_mixed_string(node->value, nexec_mgr);
-			ret = string_to_ascii(nexec_mgr->buff.str);
+			ret = string_to_ascii(Nexec_mixed_string(nexec_mgr, ast->values[node]));
 			break;
 		case E_IDENTIFIER_NODE:
-			sy = SyTable_get_symbol(nexec_mgr->sy_table, node->value);
-			// TODO: At the moment no way of telling if identifier node
-			// is a 'Number' string or 'Alpha	' string so we attempt to
-			// first convert to integer if fails then fallback to ascii encoding.
-			// A fix would be to include type information in the symbol table by
-			// deducing all identifiers prior to function execution. But is this double 
-			// handling ?
-			ret = string_to_int(sy->val, strlen(sy->val));
-			if (ret < 0) ret = string_to_ascii(sy->val);
+			val = expand_slot(nexec_mgr, node);
+			if (!val) {
+				NexecMgr_add_error(nexec_mgr->err_handle, FlatAst_value(ast, node), FlatAst_value(ast, nexec_mgr->curr));
+				break;
+			}
+			// Only strings need converting.
+			ret = Value_to_int(val);
 			break;
 		default:
 			break;
@@ -133,22 +152,33 @@ static int exec_expression(NexecMgr *nexec_mgr, Node *node) {
 	return ret;
 }
 
-// Helper to convert intger to malloc'ed string.
-static char *expr_to_string(NexecMgr *nexec_mgr, int src) {
-	char *dest = malloc(6 * sizeof(char));
-	char *out = NULL;
-	
-	// Store any additional bytes if needed.
-	int extra_b = snprintf(dest, 6, "%d" , src);
-	
-	if (extra_b > 0) {
-		out = realloc(dest, (extra_b + 6) * sizeof(char));
-		dest = out;
+Value Nexec_array(NexecMgr *nexec_mgr, FlatIdx node) {
+	if (null_check(nexec_mgr, "nexec array")) return Value_none();
+
+	FlatAst *ast = nexec_mgr->ast;
+	Value arr = Value_array(ast->rhs[node]);
+
+	// Items are literals, strings are borrowed from the tree.
+	for (size_t i = 0; arr.type == E_ARRAY_VALUE && i < ast->rhs[node]; i++) {
+		FlatIdx item = ast->kids[ast->lhs[node] + i];
+		char *value = FlatAst_value(ast, item);
+
+		switch (FlatAst_type(ast, item)) {
+			case E_INTEGER_NODE:
+				arr.as.arr->items[i] = Value_int_literal(string_to_int64(value, strlen(value)), value);
+				break;
+			case E_STRING_NODE:
+				arr.as.arr->items[i] = Value_str(value, 0);
+				break;
+			case E_ARRAY_NODE:
+				arr.as.arr->items[i] = Nexec_array(nexec_mgr, item);
+				break;
+			default:
+				break;
+		}
 	}
 
-	VString_set(&nexec_mgr->buff, dest);
-	free (dest);
-	return nexec_mgr->buff.str;
+	return arr;
 }
 
 void NexecMgr_add_error(Error *err_handle, char *offender, char *hint) {
@@ -158,32 +188,63 @@ void NexecMgr_add_error(Error *err_handle, char *offender, char *hint) {
 	if (err_handle->error_cap == err_handle->error_ctr)
 		return;
 	
-	// The error template which is needed.
-	const char *template = Error_Templates[0];
-	// Array containing string of substitute values.
-	char *template_values[] = {offender, hint};
-	// Final template error.
-	char *template_fmt = NULL;
+	VString msg = VString_new();
 
-	template_fmt = string_map_vars(template, template_values, strlen(template), 2);
+	// Assignments have no value to hint with.
+	if (VString_pushf(&msg, Error_Templates[ERR_UNDEFINE_VAR], offender, hint ? hint : ""))
+		err_handle->errors[err_handle->error_ctr++] = string_dup(VString_str(&msg));
 
-	err_handle->errors[err_handle->error_ctr] = template_fmt;
-	err_handle->error_ctr++;
+	VString_free(&msg);
 }	
 
 NexecMgr *NexecMgr_new(void) {
 	NexecMgr *n = malloc(sizeof(NexecMgr));
 	n->err_handle = NULL;
-	n->node_mgr = NULL;
+	n->ast = NULL;
 	n->scope = 0;
 	n->sy_table = NULL;
-	n->curr_node = NULL;
+	n->curr = FLAT_NONE;
+	n->mixstrs = NULL;
+	n->mixstr_ctr = 0;
+	n->transport = NULL;
+	n->inventory = NULL;
+	n->forks = 1;
+	n->timeout_ms = 0;
+	n->pool = NULL;
+	n->forked = 0;
 	return n;
 }
 
+NexecMgr *Nexec_fork(NexecMgr *nexec_mgr) {
+	if (null_check(nexec_mgr, "nexec fork")) return NULL;
+
+	NexecMgr *fork = malloc(sizeof(NexecMgr));
+	if (null_check(fork, "nexec fork"))
+		return NULL;
+
+	*fork = *nexec_mgr;
+	fork->buff = VString_new();
+	fork->err_handle = Error_new();
+	fork->forked = 1;
+	return fork;
+}
+
 int NexecMgr_free(NexecMgr *nexec_mgr) {
 	if (null_check(nexec_mgr, "nexecmgr free")) return -1;
 	VString_free(&nexec_mgr->buff);
+
+	// Forks own their errors and borrow the mixed strings and pool.
+	if (nexec_mgr->forked) {
+		if (nexec_mgr->err_handle)
+			Error_free(nexec_mgr->err_handle);
+		free(nexec_mgr);
+		return 0;
+	}
+
+	for (size_t i = 0; i < nexec_mgr->mixstr_ctr; i++)
+		MixStr_free(nexec_mgr->mixstrs[i]);
+	free(nexec_mgr->mixstrs);
+	TaskPool_free(nexec_mgr->pool);
 	free(nexec_mgr);
 	return 0;
 }
@@ -191,108 +252,168 @@ int NexecMgr_free(NexecMgr *nexec_mgr) {
 int Nexec_func_node(NexecMgr *nexec_mgr) {
 	if (null_check(nexec_mgr, "nexec func node")) return -1;
 
+	FlatAst *ast = nexec_mgr->ast;
 	// Current node in manager.
-	Node *curr_node = nexec_mgr->curr_node;
-	// Pointer to function arguments.
-	Node *curr_args = curr_node->data->FuncNode.args;
-		
-	if (string_compare(curr_node->value, "print")) {
+	FlatIdx curr_node = nexec_mgr->curr;
+	// Index of function arguments.
+	FlatIdx curr_args = ast->lhs[curr_node];
 		
-		// Result of arithmetic operations.
-		int calc = 0;
-
-		switch (curr_args->type) {
-			case E_STRING_NODE:
-			case E_INTEGER_NODE:
-				printf("%s\n", exec_string(curr_args));
-				break;
-			case E_IDENTIFIER_NODE:
-				VString_set(&nexec_mgr->buff, expand_variable(nexec_mgr->sy_table, curr_args->value));
-				if (nexec_mgr->buff.str)
-					printf("%s\n", nexec_mgr->buff.str);
-				else
-					NexecMgr_add_error(nexec_mgr->err_handle, curr_args->value, curr_node->value);
-				break;
-			case E_MIXSTR_NODE:
-				VString_set(&nexec_mgr->buff, exec_mixed_string(curr_args->value, nexec_mgr));
-				printf("%s\n", nexec_mgr->buff.str);
-				break;
-			default:
-				// Derive final value from operation node.
-				calc = exec_expression(nexec_mgr, curr_args);
-				printf("%d\n", calc);
-				break;
-		} 
+	// Result of arithmetic operations.
+	long long calc = 0;
+	// Expanded variable.
+	Value *val = NULL;
+
+	switch (ast->kwids[curr_node]) {
+		case E_KW_PRINT:
+			switch (FlatAst_type(ast, curr_args)) {
+				case E_STRING_NODE:
+				case E_INTEGER_NODE:
+					printf("%s\n", exec_string(ast, curr_args));
+					break;
+				case E_IDENTIFIER_NODE:
+					val = expand_slot(nexec_mgr, curr_args);
+					if (val)
+						printf("%s\n", Value_to_string(val, &nexec_mgr->buff));
+					else
+						NexecMgr_add_error(nexec_mgr->err_handle, FlatAst_value(ast, curr_args), FlatAst_value(ast, curr_node));
+					break;
+				case E_MIXSTR_NODE:
+					printf("%s\n", Nexec_mixed_string(nexec_mgr, ast->values[curr_args]));
+					break;
+				default:
+					// Derive final value from operation node.
+					calc = exec_expression(nexec_mgr, curr_args);
+					printf("%lld\n", calc);
+					break;
+			} 
+			break;
+		default:
+			break;
 	}
 	return 0;
 }
 
 int Nexec_group_node(NexecMgr *nexec_mgr) {
 	if (null_check(nexec_mgr, "nexec group node")) return -1;
-	return 0;
+
+	if (!nexec_mgr->transport)
+		return 0;
+
+	// Without an inventory the group runs on this machine, its output written as is.
+	if (!nexec_mgr->inventory) {
+		HostResult host = { TRANSPORT_LOCALHOST, TransportResult_new(), 0, 0 };
+		int ret = Executor_run_hosts(nexec_mgr, nexec_mgr->curr, &host, 1) == 0 && host.res.status == 0 ? 0 : -1;
+
+		VRope_fwrite(&host.res.out, stdout);
+		VRope_fwrite(&host.res.err, stderr);
+		TransportResult_free(&host.res);
+		return ret;
+	}
+
+	size_t host_ctr = nexec_mgr->inventory->host_ctr;
+	HostResult *results = Executor_run_group(nexec_mgr, nexec_mgr->curr);
+	int ret = results ? 0 : -1;
+
+	for (size_t i = 0; results && i < host_ctr; i++)
+		if (results[i].res.status != 0)
+			ret = -1;
+
+	Executor_report(results, host_ctr, stdout, stderr);
+	Executor_free_results(results, host_ctr);
+	return ret;
 }
 
 int Nexec_assignment_node(NexecMgr *nexec_mgr) {
 	if (null_check(nexec_mgr, "nexec assignment node")) return -1;
 
-	// Left child node of assignment node.
-	Node *asn_left_node = nexec_mgr->curr_node->data->AsnStmtNode.left;
+	FlatAst *ast = nexec_mgr->ast;
+	// Variable slot, left child of assignment node.
+	unsigned int asn_left = ast->rhs[ast->lhs[nexec_mgr->curr]];
 	// Right child node of assignment node.
-	Node *asn_right_node = nexec_mgr->curr_node->data->AsnStmtNode.right;
+	FlatIdx asn_right_node = ast->rhs[nexec_mgr->curr];
+	enum NodeType asn_right_type = FlatAst_type(ast, asn_right_node);
+	
+	char *value = FlatAst_value(ast, asn_right_node);
 	
 	// Determine which execution path to take based on the right side of assignment.
-	if (asn_right_node->type == E_INTEGER_NODE || asn_right_node->type == E_STRING_NODE) {
-		
-		// Simple strings and integers just update the symbol value.
-		SyTable_update_symbol(nexec_mgr->sy_table, asn_left_node->value, asn_right_node->value);
+	if (asn_right_type == E_INTEGER_NODE) {
+		// The literal is kept as written, i.e leading zeros, for printing and interpolation.
+		SyTable_update_slot(nexec_mgr->sy_table, asn_left, Value_int_literal(string_to_int64(value, strlen(value)), value));
+	}
+	else if (asn_right_type == E_STRING_NODE) {
+		// Interned strings outlive the symbol table, no need to copy.
+		SyTable_update_slot(nexec_mgr->sy_table, asn_left, Value_str(value, 0));
 	}
-	else if (asn_right_node->type == E_IDENTIFIER_NODE) {	
+	else if (asn_right_type == E_IDENTIFIER_NODE) {	
 		// First expand variable value from symbol table.
-		VString_set(&nexec_mgr->buff, expand_variable(nexec_mgr->sy_table, asn_right_node->value));
-		if (nexec_mgr->buff.str)
-			SyTable_update_symbol(nexec_mgr->sy_table, asn_left_node->value, nexec_mgr->buff.str);
+		Value *val = expand_slot(nexec_mgr, asn_right_node);
+		if (val)
+			SyTable_update_slot(nexec_mgr->sy_table, asn_left, Value_copy(val));
 	}
-	//TODO: Since no concept of ternary operators we can group storage of below.
-	else if (Node_is_binop(asn_right_node)|| Node_is_compare(asn_right_node)) {
-		
-		// Derive final value from operation node.
-		int calc = exec_expression(nexec_mgr, asn_right_node); 
-		// Convert the integer to string.
-		expr_to_string(nexec_mgr, calc);
-		SyTable_update_symbol(nexec_mgr->sy_table, asn_left_node->value, nexec_mgr->buff.str);
+	else if (FlatAst_is_binop(asn_right_type)) {
+		SyTable_update_slot(nexec_mgr->sy_table, asn_left, Value_int(exec_expression(nexec_mgr, asn_right_node)));
+	}
+	else if (FlatAst_is_compare(asn_right_type)) {
+		SyTable_update_slot(nexec_mgr->sy_table, asn_left, Value_bool(exec_expression(nexec_mgr, asn_right_node)));
+	}
+	else if (asn_right_type == E_MIXSTR_NODE) {
+		value = Nexec_mixed_string(nexec_mgr, ast->values[asn_right_node]);
+		SyTable_update_slot(nexec_mgr->sy_table, asn_left, Value_str(string_dup(value), 1));
 	}
-	else if (asn_right_node->type == E_MIXSTR_NODE) {
-		exec_mixed_string(asn_right_node->value, nexec_mgr);
-		SyTable_update_symbol(nexec_mgr->sy_table, asn_left_node->value, nexec_mgr->buff.str);
+	else if (asn_right_type == E_ARRAY_NODE) {
+		SyTable_update_slot(nexec_mgr->sy_table, asn_left, Nexec_array(nexec_mgr, asn_right_node));
 	}
 
 	return 0;
 }
 
-NexecMgr *Nexec_init(SyTable *sy_table, NodeMgr *node_mgr, Error *err_handle) {
-	if (null_check(sy_table, "nexec init") || null_check(node_mgr, "nexec init")) return NULL;
+NexecMgr *Nexec_init(SyTable *sy_table, FlatAst *ast, Error *err_handle) {
+	if (null_check(sy_table, "nexec init") || null_check(ast, "nexec init")) return NULL;
 
 	// Setup wrapper structs.
 	NexecMgr *nexec_mgr = NexecMgr_new();
-	nexec_mgr->node_mgr = node_mgr;
+	nexec_mgr->ast = ast;
 	nexec_mgr->sy_table = sy_table;
 	nexec_mgr->err_handle = err_handle;
 	nexec_mgr->buff = VString_new();
+	nexec_mgr->mixstrs = calloc(ast->str_ctr + 1, sizeof(MixStr *));
+
+	if (null_check(nexec_mgr->mixstrs, "nexec init")) {
+		NexecMgr_free(nexec_mgr);
+		return NULL;
+	}
+	nexec_mgr->mixstr_ctr = ast->str_ctr;
+
+	// Compile every mixed string once, nodes sharing a string share its MixStr.
+	for (size_t i = 0; i < ast->node_ctr; i++) {
+		unsigned int str = ast->values[i];
+
+		if (FlatAst_type(ast, i) != E_MIXSTR_NODE || str == FLAT_NONE || nexec_mgr->mixstrs[str])
+			continue;
+
+		if (!(nexec_mgr->mixstrs[str] = MixStr_compile(ast->strs[str], sy_table))) {
+			NexecMgr_free(nexec_mgr);
+			return NULL;
+		}
+	}
 
 	return nexec_mgr;
 }
 
-int Nexec_exec(NexecMgr *nexec_mgr, Node *node) {
-	if (null_check(node ,"nexec exec") || null_check(node ,"nexec exec")) return -1;
+int Nexec_exec(NexecMgr *nexec_mgr, FlatIdx node) {
+	if (null_check(nexec_mgr, "nexec exec") || node >= nexec_mgr->ast->node_ctr) return -1;
 	
-	nexec_mgr->curr_node = node;
-	switch (node->type) {
+	nexec_mgr->curr = node;
+	switch (FlatAst_type(nexec_mgr->ast, node)) {
 			case E_FUNC_NODE:
 				Nexec_func_node(nexec_mgr);
 				break;
 			case E_EQUAL_NODE:
 				Nexec_assignment_node(nexec_mgr);
 				break;
+			case E_GROUP_NODE:
+				Nexec_group_node(nexec_mgr);
+				break;
 			default:
 				break;
 	}
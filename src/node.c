@@ -10,6 +10,7 @@ NodeMgr *NodeMgr_new(void) {
     node_mgr->nodes_ctr = 0;
     node_mgr->nodes_cap = INIT_NODEMGR_SIZE;
     node_mgr->nodes = malloc(node_mgr->nodes_cap * sizeof(Node *));
+    node_mgr->arena = Arena_new(0);
     return node_mgr;
 }
 
@@ -25,98 +26,43 @@ int Node_is_binop(Node *n) {
 			|| n->type == E_DIV_NODE || n->type == E_TIMES_NODE);
 }
 
-static int is_array_node(Node *n) {
-	return 	n->type ==  E_ARRAY_NODE;
-}
-
-static void node_free(Node *node) {
-	if (!node) 
-		return;
-	
-	if (Node_is_binop(node) || Node_is_compare(node)) {
-		node_free(node->data->BinExpNode.left);
-		node_free(node->data->BinExpNode.right);
-		free(node->data);
-	}
-	else if (is_array_node(node)) {
-		for (size_t i = 0; i < node->data->ArrayNode.dctr; i++) {
-			if (is_array_node(node->data->ArrayNode.items[i])) {
-				node_free(node->data->ArrayNode.items[i]);	
-			}
-			else {
-				free(node->data->ArrayNode.items[i]);
-			}
-		} 	
-
-		free(node->data->ArrayNode.items);
-		free(node->data);	
-	}
-
-	free(node);
-}
-
 int NodeMgr_free(NodeMgr *node_mgr) {
     if (null_check(node_mgr,"nodemgr free")) return -1;
 
-    Node *root_node = NULL;     
-    Node *itr = NULL;
-    Node *prev = NULL;
-    
-    for (size_t n = 0; n < node_mgr->nodes_ctr; n++) {
-		root_node = node_mgr->nodes[n];
-        switch (root_node->type) {
-            case E_EQUAL_NODE:
-				itr = root_node->data->AsnStmtNode.right;
-				free(root_node->data->AsnStmtNode.left);
-				node_free(itr);
-                break;
-			case E_FUNC_NODE:
-				node_free(root_node->data->FuncNode.args);
-				break;
-			case E_GROUP_NODE:
-                itr = root_node->data->GroupNode.next;
-				while (itr && itr != root_node) {
-                    prev = itr;
-                    itr = itr->data->GroupNode.next;
-                    free(prev->data);
-                    free(prev);
-				}
-                break;
-            default:
-                break;
-        }
-
-        /**
-         * Free root node of every AST.
-         *             =   ---> free this node.
-         *           /   \
-         *          /     \
-         *          s      +
-         *                / \
-         *               /   \
-         *              1     3
-         */               
-        free(root_node->data);
-        free(root_node);
-    }
-
+	// Nodes all live in the arena, no need to walk the trees.
+	Arena_free(node_mgr->arena);
 	free(node_mgr->nodes);
     free(node_mgr);
     return 0;
 }
 
-Node *Node_new(int wdata) {
-    Node *n = malloc(sizeof(struct Node));
-    
-    // Malloc data if needed.
-    if (wdata)
-        n->data = malloc(sizeof(union SyntaxNode));
-    else
-        n->data = NULL;
-    
-    n->depth = 0;
-    n->type = E_EOF_NODE;
-    return n;
+void NodeMgr_reset(NodeMgr *node_mgr) {
+	if (null_check(node_mgr, "nodemgr reset")) return;
+
+	Arena_reset(node_mgr->arena);
+	node_mgr->nodes_ctr = 0;
+}
+
+void *NodeMgr_alloc(NodeMgr *node_mgr, size_t size) {
+	if (null_check(node_mgr, "nodemgr alloc")) return NULL;
+	return Arena_alloc(node_mgr->arena, size);
+}
+
+Node *NodeMgr_new_node(NodeMgr *node_mgr, int wdata) {
+	if (null_check(node_mgr, "nodemgr new node")) return NULL;
+
+	// Node and data share one allocation.
+	size_t size = sizeof(struct Node) + (wdata ? sizeof(union SyntaxNode) : 0);
+	Node *n = Arena_alloc(node_mgr->arena, size);
+
+	if (null_check(n, "nodemgr new node")) return NULL;
+
+	n->data = wdata ? (union SyntaxNode *) (n + 1) : NULL;
+	n->depth = 0;
+	n->type = E_EOF_NODE;
+	n->kwid = E_KW_NONE;
+	n->value = NULL;
+	return n;
 }
 
 Node **grow_nodes(NodeMgr *node_mgr) {
@@ -152,3 +98,52 @@ Node *NodeMgr_find_node(NodeMgr *node_mgr, char *value) {
 
 	return itr;
 }
+
+// Names of node types for printing.
+static const char *Node_Type_Names[] = {
+	"ADD", "TIMES", "DIV", "MINUS", "EQUAL", "STRING", "MIXSTR", "INTEGER",
+	"GROUP", "FUNC", "IDENTIFIER", "ARRAY", "EEQUAL", "NEQUAL", "LESSTHAN",
+	"LESSTHANEQ", "GREATERTHAN", "GREATERTHANEQ", "BETWEEN", "EOF"
+};
+
+// Print a tree, one node per line indented by depth.
+static void node_print_tree(Node *n, unsigned int depth) {
+	printf("%*s", depth * 2, "");
+
+	if (!n) {
+		printf("(null)\n");
+		return;
+	}
+
+	printf("%s", Node_Type_Names[n->type]);
+	if (n->value)
+		printf(" %s", n->value);
+	printf("\n");
+
+	if (Node_is_binop(n) || Node_is_compare(n) || n->type == E_EQUAL_NODE) {
+		node_print_tree(n->data->BinExpNode.left, depth + 1);
+		node_print_tree(n->data->BinExpNode.right, depth + 1);
+	}
+	else if (n->type == E_FUNC_NODE) {
+		node_print_tree(n->data->FuncNode.args, depth + 1);
+	}
+	else if (n->type == E_ARRAY_NODE) {
+		for (size_t i = 0; i < n->data->ArrayNode.dctr; i++)
+			node_print_tree(n->data->ArrayNode.items[i], depth + 1);
+	}
+	else if (n->type == E_GROUP_NODE) {
+		// Commands link back to the group.
+		for (Node *cmd = n->data->GroupNode.next; cmd && cmd != n; cmd = cmd->data->GroupNode.next)
+			node_print_tree(cmd, depth + 1);
+	}
+}
+
+void NodeMgr_print_trees(NodeMgr *node_mgr, const char *title) {
+	if (null_check(node_mgr, "nodemgr print")) return;
+
+	printf("--------------------------------------\n");
+	printf("** AST Dump (%s) **\n", title);
+	printf("--------------------------------------\n");
+	for (size_t i = 0; i < node_mgr->nodes_ctr; i++)
+		node_print_tree(node_mgr->nodes[i], 0);
+}
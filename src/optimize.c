@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "optimize.h"
+#include "tokens.h"
+#include "utils.h"
+#include "value.h"
+
+/**
+ * @brief State kept while optimizing.
+ */
+typedef struct {
+	InternPool *pool;
+	int rewrites;
+	int failed;
+} Optimizer;
+
+// Determine whether a node evaluates an operator the executor implements.
+static int opt_is_operator(Node *node) {
+	return (Node_is_binop(node) || Node_is_compare(node)) && node->type != E_BETWEEN_NODE;
+}
+
+// Evaluate an operator over constants as the executor would, returns 0 if it can't be folded.
+static int opt_eval(enum NodeType type, long long lhs, long long rhs, long long *val) {
+	switch (type) {
+		case E_ADD_NODE: *val = VALUE_WRAP(lhs, +, rhs); break;
+		case E_MINUS_NODE: *val = VALUE_WRAP(lhs, -, rhs); break;
+		case E_TIMES_NODE: *val = VALUE_WRAP(lhs, *, rhs); break;
+		case E_DIV_NODE: *val = Value_div(lhs, rhs); break;
+		case E_EEQUAL_NODE: *val = lhs == rhs; break;
+		case E_NEQUAL_NODE: *val = lhs != rhs; break;
+		case E_LESSTHAN_NODE: *val = lhs < rhs; break;
+		case E_LESSTHANEQ_NODE: *val = lhs <= rhs; break;
+		case E_GREATERTHAN_NODE: *val = lhs > rhs; break;
+		case E_GREATERTHANEQ_NODE: *val = lhs >= rhs; break;
+		default: return 0;
+	}
+	return 1;
+}
+
+// Turn a folded operator into an integer node.
+static void opt_literal(Optimizer *opt, Node *node, long long val) {
+	char num[24];
+
+	// Negative literals don't exist, string_to_int64() would read them back as -1,
+	// so negative results are left to the executor.
+	if (!opt_is_operator(node) || val < 0)
+		return;
+
+	int len = snprintf(num, sizeof(num), "%lld", val);
+	char *value = InternPool_intern(opt->pool, num, len);
+
+	if (!value) {
+		opt->failed = 1;
+		return;
+	}
+
+	node->type = E_INTEGER_NODE;
+	node->value = value;
+	opt->rewrites++;
+}
+
+// Optimize the tree at slot. in_expr is set when the value is used as an operand,
+// returns 1 with val set if it evaluates to a constant.
+static int opt_node(Optimizer *opt, Node **slot, int in_expr, long long *val) {
+	Node *node = *slot;
+	long long lhs = 0;
+	long long rhs = 0;
+
+	if (!node || opt->failed)
+		return 0;
+
+	switch (node->type) {
+		case E_INTEGER_NODE:
+			*val = string_to_int64(node->value, strlen(node->value));
+			return 1;
+		case E_MIXSTR_NODE:
+			if (strchr(node->value, VAR))
+				return 0;
+			// Nothing to expand, same as a plain string.
+			node->type = E_STRING_NODE;
+			opt->rewrites++;
+			// fall through
+		case E_STRING_NODE:
+			*val = string_to_ascii(node->value);
+			return 1;
+		case E_EQUAL_NODE:
+			opt_node(opt, &node->data->AsnStmtNode.right, 0, &rhs);
+			return 0;
+		case E_FUNC_NODE:
+			opt_node(opt, &node->data->FuncNode.args, 0, &rhs);
+			return 0;
+		case E_ARRAY_NODE:
+			for (size_t i = 0; i < node->data->ArrayNode.dctr; i++)
+				opt_node(opt, &node->data->ArrayNode.items[i], 0, &rhs);
+			return 0;
+		default:
+			break;
+	}
+
+	if (!opt_is_operator(node))
+		return 0;
+
+	Node **left = &node->data->BinExpNode.left;
+	Node **right = &node->data->BinExpNode.right;
+	int lconst = opt_node(opt, left, 1, &lhs);
+	int rconst = opt_node(opt, right, 1, &rhs);
+
+	if (lconst && rconst && opt_eval(node->type, lhs, rhs, val)) {
+		// Operands fold into the parent, only the outermost constant becomes a literal.
+		if (!in_expr)
+			opt_literal(opt, node, *val);
+		return 1;
+	}
+
+	if (lconst)
+		opt_literal(opt, *left, lhs);
+	if (rconst)
+		opt_literal(opt, *right, rhs);
+
+	// Strings and variables are evaluated differently on their own than as
+	// operands, so x may only replace x op identity where the result is an operand
+	// or x is an operator itself.
+	if (rconst && (in_expr || opt_is_operator(*left))
+		&& (((node->type == E_ADD_NODE || node->type == E_MINUS_NODE) && rhs == 0)
+		|| ((node->type == E_TIMES_NODE || node->type == E_DIV_NODE) && rhs == 1))) {
+		*slot = *left;
+		opt->rewrites++;
+	}
+	else if (lconst && (in_expr || opt_is_operator(*right))
+		&& ((node->type == E_ADD_NODE && lhs == 0) || (node->type == E_TIMES_NODE && lhs == 1))) {
+		*slot = *right;
+		opt->rewrites++;
+	}
+
+	return 0;
+}
+
+int Optimize_ast(NodeMgr *node_mgr, InternPool *pool) {
+	if (null_check(node_mgr, "optimize ast") || null_check(pool, "optimize ast")) return -1;
+
+	Optimizer opt = { pool, 0, 0 };
+	long long val = 0;
+
+	for (size_t i = 0; i < node_mgr->nodes_ctr && !opt.failed; i++)
+		opt_node(&opt, &node_mgr->nodes[i], 0, &val);
+
+	return opt.failed ? -1 : opt.rewrites;
+}
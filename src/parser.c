@@ -41,6 +41,11 @@ static void par_mgr_sync(ParserMgr *par_mgr) {
 	par_mgr->curr_token = TokenMgr_current_token(par_mgr->tok_mgr);
 }
 
+// Get the value of a token.
+static char *tok_value(ParserMgr *par_mgr, Token *tok) {
+	return TokenMgr_token_value(par_mgr->tok_mgr, tok);
+}
+
 // Increment the token within TokenMgr and assign it to par_mgr.
 static void par_mgr_next(ParserMgr *par_mgr) {
 	par_mgr->curr_token = TokenMgr_next_token(par_mgr->tok_mgr);
@@ -59,50 +64,47 @@ static int is_compare_operator(TokenType op) {
 }
 
 // Return the type of compare node based on token.
-static enum NodeType get_compare_type(char *op) {
-	if (string_compare(op, "==")) {
-		return E_EEQUAL_NODE;
-	}
-	else if (string_compare(op, "!=")) {
-		return E_NEQUAL_NODE;
-	}
-	else if (string_compare(op, "<")) {
-		return E_LESSTHAN_NODE;
-	}
-	else if (string_compare(op, "<=")) {
-		return E_LESSTHANEQ_NODE;
+static enum NodeType get_compare_type(TokenType op) {
+	switch (op) {
+		case E_EEQUAL_TOKEN:
+			return E_EEQUAL_NODE;
+		case E_NEQUAL_TOKEN:
+			return E_NEQUAL_NODE;
+		case E_LESSTHAN_TOKEN:
+			return E_LESSTHAN_NODE;
+		case E_LESSTHANEQ_TOKEN:
+			return E_LESSTHANEQ_NODE;
+		case E_GREATERTHAN_TOKEN:
+			return E_GREATERTHAN_NODE;
+		case E_GREATERTHANEQ_TOKEN:
+			return E_GREATERTHANEQ_NODE;
+		case E_BETWEEN_TOKEN:
+			return E_BETWEEN_NODE;
+		default:
+			return E_EOF_NODE;
 	}
-	else if (string_compare(op, ">")) {
-		return E_GREATERTHAN_NODE;
-	}
-	else if (string_compare(op, ">=")) {
-		return E_GREATERTHANEQ_NODE;
-	}
-	else if (string_compare(op, "><")) {
-		return E_BETWEEN_NODE;
-	}
-
-	return E_EOF_NODE;
 }
 
-// Allocate more memory for array node items.
-static Node **grow_arr_nodes(Node *arr_node) {
+// Allocate more memory for array node items, old items are left to the arena.
+static Node **grow_arr_nodes(NodeMgr *node_mgr, Node *arr_node) {
 	if (null_check(arr_node, "grow array nodes")) return NULL;
 	Node **new_items = NULL;
 	arr_node->data->ArrayNode.dcap = arr_node->data->ArrayNode.dcap * (arr_node->data->ArrayNode.dcap / 2);
-	new_items = realloc(arr_node->data->ArrayNode.items, arr_node->data->ArrayNode.dcap * sizeof(Node *));
+	new_items = NodeMgr_alloc(node_mgr, arr_node->data->ArrayNode.dcap * sizeof(Node *));
+	if (new_items)
+		memcpy(new_items, arr_node->data->ArrayNode.items, arr_node->data->ArrayNode.dctr * sizeof(Node *));
 	return new_items;
 }
 
-// Shorthand for malloc'ed array node and items.
-static Node *node_new_array() {
+// Shorthand for array node and items.
+static Node *node_new_array(NodeMgr *node_mgr) {
 	Node *arr = NULL;
-	arr = Node_new(1);
+	arr = NodeMgr_new_node(node_mgr, 1);
 	arr->type = E_ARRAY_NODE;
 	arr->data->ArrayNode.dctr = 0;
 	arr->data->ArrayNode.dcap = 15;
 	arr->value = NULL;
-	arr->data->ArrayNode.items = malloc(arr->data->ArrayNode.dcap * sizeof(Node *));
+	arr->data->ArrayNode.items = NodeMgr_alloc(node_mgr, arr->data->ArrayNode.dcap * sizeof(Node *));
 	return arr;
 }
 
@@ -115,7 +117,7 @@ static int parser_expects(ParserMgr *par_mgr, int err_code, int ct, ...) {
 	for( int i = 0 ; i < ct; i++ ) {
 		arg = va_arg( ap, int);
 		if (par_mgr->curr_token->type != arg) {
-			ParserMgr_add_error(par_mgr->err_handle, par_mgr->curr_token, err_code);
+			ParserMgr_add_error(par_mgr, par_mgr->curr_token, err_code);
 			par_mgr_next(par_mgr);
 			ret = 0;
 		}
@@ -145,13 +147,15 @@ int ParserMgr_free(ParserMgr *par_mgr) {
 	return 0;
 }
 
-void ParserMgr_add_error(Error *err_handle, Token *offender, int err_type) {
+void ParserMgr_add_error(ParserMgr *par_mgr, Token *offender, int err_type) {
+	Error *err_handle = par_mgr->err_handle;
+
 	// Don't exceed error limit.
 	if (err_handle->error_cap == err_handle->error_ctr)
 		return;
 	 
 	char off_lineno[16]; // Assume that a source file won't exceed 9999,9999,9999,9999 lines ?
-	char *off_value = offender->value;
+	char *off_value = tok_value(par_mgr, offender);
 	const char *template = Error_Templates[err_type];
 	char *template_values[] = {off_value, off_lineno};
 	char *template_fmt = NULL;
@@ -176,14 +180,14 @@ void ParserMgr_skip_to(ParserMgr *par_mgr, TokenType type) {
 Node *parse_string(ParserMgr *par_mgr) {
 	Node *str = NULL;
 	if (par_mgr->curr_token->type == E_STRING_TOKEN || par_mgr->curr_token->type == E_MIXSTR_TOKEN) {
-		str = Node_new(0);
+		str = NodeMgr_new_node(par_mgr->node_mgr, 0);
 		str->type = E_STRING_NODE;
 		
 		// Change type if mix string.
 		if (par_mgr->curr_token->type == E_MIXSTR_TOKEN)
 			str->type = E_MIXSTR_NODE;
 			
-		str->value = par_mgr->curr_token->value;
+		str->value = tok_value(par_mgr, par_mgr->curr_token);
 		par_mgr_next(par_mgr);
 	}
 	return str;
@@ -193,15 +197,15 @@ Node *parse_factor(ParserMgr *par_mgr) {
 	par_mgr_sync(par_mgr);
 	Node *res = NULL;
 	 if (par_mgr->curr_token->type == E_INTEGER_TOKEN) {
-		 res = Node_new(0);
+		 res = NodeMgr_new_node(par_mgr->node_mgr, 0);
 		 res->type = E_INTEGER_NODE;
-		 res->value = par_mgr->curr_token->value; 
+		 res->value = tok_value(par_mgr, par_mgr->curr_token); 
 		 par_mgr_next(par_mgr);
 	 }
 	 else if (par_mgr->curr_token->type == E_IDENTIFIER_TOKEN) {
-		 res = Node_new(0);
+		 res = NodeMgr_new_node(par_mgr->node_mgr, 0);
 		 res->type = E_IDENTIFIER_NODE;
-		 res->value = par_mgr->curr_token->value; 
+		 res->value = tok_value(par_mgr, par_mgr->curr_token); 
 		 par_mgr_next(par_mgr);
 	 }
 	 else if (par_mgr->curr_token->type == E_LPAREN_TOKEN) {
@@ -211,7 +215,7 @@ Node *parse_factor(ParserMgr *par_mgr) {
 		 
 		 // Should have closing paren.
 		 if (par_mgr->curr_token->type != E_RPAREN_TOKEN)
-			 ParserMgr_add_error(par_mgr->err_handle, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_MISSING_PAREN);
+			 ParserMgr_add_error(par_mgr, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_MISSING_PAREN);
 	 }
 	 else {
 		 res = parse_string(par_mgr);
@@ -227,7 +231,7 @@ Node *parse_term(ParserMgr *par_mgr) {
 		|| par_mgr->curr_token->type == E_ASTERISK_TOKEN)) {
 		
 		// Operation node.
-		Node *bop = Node_new(1);
+		Node *bop = NodeMgr_new_node(par_mgr->node_mgr, 1);
 
 		if (par_mgr->curr_token->type == E_ASTERISK_TOKEN) {
 			bop->type = E_TIMES_NODE;
@@ -236,7 +240,7 @@ Node *parse_term(ParserMgr *par_mgr) {
 			bop->type = E_DIV_NODE;
 		}
 		else {
-			ParserMgr_add_error(par_mgr->err_handle, par_mgr->curr_token, ERR_UNEXPECTED);
+			ParserMgr_add_error(par_mgr, par_mgr->curr_token, ERR_UNEXPECTED);
 			TokenMgr_next_token(par_mgr->tok_mgr);
 		}
 
@@ -245,7 +249,7 @@ Node *parse_term(ParserMgr *par_mgr) {
 		bop->data->BinExpNode.right = parse_factor(par_mgr);
 
 		if (!bop->data->BinExpNode.right || !bop->data->BinExpNode.left) {
-			ParserMgr_add_error(par_mgr->err_handle, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_INVALID_TYPES);
+			ParserMgr_add_error(par_mgr, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_INVALID_TYPES);
 			TokenMgr_next_token(par_mgr->tok_mgr);
 		}
 
@@ -265,7 +269,7 @@ Node *parse_expr(ParserMgr *par_mgr) {
 		|| is_compare_operator(par_mgr->curr_token->type))) {
 		
 		// Operation node.
-		Node *bop = Node_new(1);
+		Node *bop = NodeMgr_new_node(par_mgr->node_mgr, 1);
 
 		if (par_mgr->curr_token->type == E_MINUS_TOKEN) {
 			bop->type = E_MINUS_NODE;
@@ -273,10 +277,10 @@ Node *parse_expr(ParserMgr *par_mgr) {
 			bop->type = E_ADD_NODE;
 		}
 		else if (is_compare_operator(par_mgr->curr_token->type)) {
-			bop->type = get_compare_type(par_mgr->curr_token->value);
+			bop->type = get_compare_type(par_mgr->curr_token->type);
 		}
 		else {
-			ParserMgr_add_error(par_mgr->err_handle, par_mgr->curr_token, ERR_UNEXPECTED);
+			ParserMgr_add_error(par_mgr, par_mgr->curr_token, ERR_UNEXPECTED);
 			TokenMgr_next_token(par_mgr->tok_mgr);
 		}
 
@@ -285,7 +289,7 @@ Node *parse_expr(ParserMgr *par_mgr) {
 		bop->data->BinExpNode.right = parse_term(par_mgr);
 
 		if (!bop->data->BinExpNode.right || !bop->data->BinExpNode.left) {
-			ParserMgr_add_error(par_mgr->err_handle, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_INVALID_TYPES);
+			ParserMgr_add_error(par_mgr, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_INVALID_TYPES);
 			TokenMgr_next_token(par_mgr->tok_mgr);
 		}
 
@@ -307,7 +311,7 @@ Node *parse_array(ParserMgr *par_mgr) {
 		return NULL;
 
 	// Instansiate array node.
-	arr = node_new_array();
+	arr = node_new_array(par_mgr->node_mgr);
 	
 	while (!TokenMgr_is_last_token(par_mgr->tok_mgr) && par_mgr->curr_token->type != E_RBRACKET_TOKEN) {
 		
@@ -336,13 +340,13 @@ Node *parse_array(ParserMgr *par_mgr) {
 
 		// Resize if need be, prior to appending array node.
 		if (arr->data->ArrayNode.dcap - arr->data->ArrayNode.dctr <= 5)
-			arr->data->ArrayNode.items = grow_arr_nodes(arr);
+			arr->data->ArrayNode.items = grow_arr_nodes(par_mgr->node_mgr, arr);
 
 		arr->data->ArrayNode.items[arr->data->ArrayNode.dctr++] = ret;	
 	}
 	
 	if (par_mgr->curr_token->type != E_RBRACKET_TOKEN)
-		ParserMgr_add_error(par_mgr->err_handle, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_MISSING_BRACKET);
+		ParserMgr_add_error(par_mgr, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_MISSING_BRACKET);
 	else
 		par_mgr_next(par_mgr);
 	
@@ -371,27 +375,27 @@ Node *parse_assignment(ParserMgr *par_mgr) {
 		if ((expr = parse_expr(par_mgr)) || (expr = parse_array(par_mgr))) {
 
 			// Add symbol if not exits.
-			if (!SyTable_get_symbol(par_mgr->sy_table, tok_start_ptr->value))
-				SyTable_add_symbol(par_mgr->sy_table, tok_start_ptr->value, NULL, tok_start_ptr->lineno ,E_IDN_TYPE);
+			if (!SyTable_find_symbol(par_mgr->sy_table, tok_value(par_mgr, tok_start_ptr)))
+				SyTable_add_symbol(par_mgr->sy_table, tok_value(par_mgr, tok_start_ptr), NULL, tok_start_ptr->lineno ,E_IDN_TYPE);
 			
 			// Identifier.
-			lhand = Node_new(0); 
+			lhand = NodeMgr_new_node(par_mgr->node_mgr, 0); 
 			lhand->type = E_IDENTIFIER_NODE;
-			lhand->value = tok_start_ptr->value;
+			lhand->value = tok_value(par_mgr, tok_start_ptr);
 
 			// Join to return ast from expression.
-			ast = Node_new(1); 
+			ast = NodeMgr_new_node(par_mgr->node_mgr, 1); 
 			ast->type = E_EQUAL_NODE;
 			ast->data->AsnStmtNode.left = lhand;
 			ast->data->AsnStmtNode.right = expr;
 		}
 		else {
-			ParserMgr_add_error(par_mgr->err_handle, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_UNEXPECTED);
+			ParserMgr_add_error(par_mgr, TokenMgr_prev_token(par_mgr->tok_mgr), ERR_UNEXPECTED);
 			par_mgr_next(par_mgr);
 		}
 	}
 	else {
-		ParserMgr_add_error(par_mgr->err_handle,TokenMgr_prev_token(par_mgr->tok_mgr), ERR_NAKED_VARIABLE);
+		ParserMgr_add_error(par_mgr,TokenMgr_prev_token(par_mgr->tok_mgr), ERR_NAKED_VARIABLE);
 		par_mgr_next(par_mgr);
 	}
 	return ast;
@@ -406,8 +410,8 @@ Node *parse_group(ParserMgr *par_mgr) {
 	if (!parser_expects(par_mgr, ERR_UNEXPECTED, 1, E_LBRACE_TOKEN)) return NULL;
 
 	// Check if group already defined.
-	if (SyTable_get_symbol(par_mgr->sy_table, par_mgr->curr_token->value)) {
-		ParserMgr_add_error(par_mgr->err_handle, par_mgr->curr_token, ERR_GROUP_EXIST);
+	if (SyTable_find_symbol(par_mgr->sy_table, tok_value(par_mgr, par_mgr->curr_token))) {
+		ParserMgr_add_error(par_mgr, par_mgr->curr_token, ERR_GROUP_EXIST);
 		par_mgr_next(par_mgr);
 		return NULL;
 	}
@@ -415,13 +419,13 @@ Node *parse_group(ParserMgr *par_mgr) {
 	par_mgr_next(par_mgr);
 
 	// Group node itself. i.e {some_group}.
-	Node *group = Node_new(1);
+	Node *group = NodeMgr_new_node(par_mgr->node_mgr, 1);
 	// Previously read command.
 	Node *prev = NULL;
 	// Recently read command.
 	Node *curr = NULL;
 	// Setup group node data.
-	group->value = grp->value;
+	group->value = tok_value(par_mgr, grp);
 	group->data->GroupNode.next = NULL;
 	group->type = E_GROUP_NODE;
 
@@ -432,7 +436,7 @@ Node *parse_group(ParserMgr *par_mgr) {
 	// Below will build a circular single linked list.
 	while (!TokenMgr_is_last_token(par_mgr->tok_mgr) && par_mgr->curr_token->type == E_STRING_TOKEN) {
 		curr = parse_string(par_mgr);
-		curr->data = malloc(sizeof(union SyntaxNode));
+		curr->data = NodeMgr_alloc(par_mgr->node_mgr, sizeof(union SyntaxNode));
 		
 		if (!prev)
 			group->data->GroupNode.next = curr;
@@ -464,7 +468,7 @@ Node *parse_keyword(ParserMgr *par_mgr) {
 		&& peek->type != E_MIXSTR_TOKEN
 		&& peek->type != E_INTEGER_TOKEN
 		&& peek->type != E_IDENTIFIER_TOKEN) {
-		ParserMgr_add_error(par_mgr->err_handle, TokenMgr_current_token(par_mgr->tok_mgr), ERR_EMPTY_STMT);
+		ParserMgr_add_error(par_mgr, TokenMgr_current_token(par_mgr->tok_mgr), ERR_EMPTY_STMT);
 		par_mgr_next(par_mgr);
 		return NULL;
 	}
@@ -481,13 +485,14 @@ Node *parse_keyword(ParserMgr *par_mgr) {
 	// If args is valid then store.
 	// TODO: Consolidate below to one ?
 	if ((args = parse_expr(par_mgr)) || (args = parse_string(par_mgr))) {
-		stmt = Node_new(1);
+		stmt = NodeMgr_new_node(par_mgr->node_mgr, 1);
 		stmt->type = E_FUNC_NODE;
-		stmt->value = name->value;
+		stmt->value = tok_value(par_mgr, name);
+		stmt->kwid = name->kwid;
 		stmt->data->FuncNode.args = args;
 	}
 	else {
-		ParserMgr_add_error(par_mgr->err_handle, TokenMgr_current_token(par_mgr->tok_mgr), ERR_UNEXPECTED);
+		ParserMgr_add_error(par_mgr, TokenMgr_current_token(par_mgr->tok_mgr), ERR_UNEXPECTED);
 		par_mgr_next(par_mgr);
 	}
 
@@ -520,7 +525,7 @@ Node *Parser_parse(ParserMgr *par_mgr) {
 			ast = parse_keyword(par_mgr);
 		}
 		else {
-			ParserMgr_add_error(par_mgr->err_handle, par_mgr->curr_token, ERR_UNEXPECTED);
+			ParserMgr_add_error(par_mgr, par_mgr->curr_token, ERR_UNEXPECTED);
 			par_mgr_next(par_mgr);
 			continue;
 		}
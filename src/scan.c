@@ -0,0 +1,182 @@
+#include <string.h>
+#include "scan.h"
+#include "tokens.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Set of scanners for one instruction set.
+ */
+typedef struct {
+	const char *name;
+	size_t (*until)(const char *buff, size_t len, size_t idx, char delim);
+	size_t (*space)(const char *buff, size_t len, size_t idx, int *lines);
+} ScanImpl;
+
+static size_t until_scalar(const char *buff, size_t len, size_t idx, char delim) {
+	while (idx < len && buff[idx] != delim && buff[idx] != NEWLINE && buff[idx] != '\0') {
+		idx++;
+	}
+	return idx;
+}
+
+static size_t space_scalar(const char *buff, size_t len, size_t idx, int *lines) {
+	while (idx < len && (char_is(buff[idx], CF_SPACE) || buff[idx] == NEWLINE)) {
+		if (buff[idx] == NEWLINE)
+			(*lines)++;
+		idx++;
+	}
+	return idx;
+}
+
+static const ScanImpl Scan_scalar = { "scalar", until_scalar, space_scalar };
+
+#ifdef SCAN_X86
+
+__attribute__((target("sse2")))
+static size_t until_sse2(const char *buff, size_t len, size_t idx, char delim) {
+	const __m128i vdelim = _mm_set1_epi8(delim);
+	const __m128i vnl = _mm_set1_epi8(NEWLINE);
+	const __m128i vnul = _mm_setzero_si128();
+
+	while (idx + 16 <= len) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (buff + idx));
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, vdelim), _mm_cmpeq_epi8(v, vnl)), _mm_cmpeq_epi8(v, vnul));
+		unsigned int mask = _mm_movemask_epi8(hit);
+		if (mask)
+			return idx + __builtin_ctz(mask);
+		idx += 16;
+	}
+	return until_scalar(buff, len, idx, delim);
+}
+
+__attribute__((target("sse2")))
+static size_t space_sse2(const char *buff, size_t len, size_t idx, int *lines) {
+	const __m128i vsp = _mm_set1_epi8(' ');
+	const __m128i vnl = _mm_set1_epi8(NEWLINE);
+	// \t \n \v \f \r are contiguous, test them with a single range check.
+	const __m128i vlo = _mm_set1_epi8('\t' - 1);
+	const __m128i vhi = _mm_set1_epi8('\r' + 1);
+
+	while (idx + 16 <= len) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (buff + idx));
+		__m128i ctl = _mm_and_si128(_mm_cmpgt_epi8(v, vlo), _mm_cmplt_epi8(v, vhi));
+		unsigned int ws = _mm_movemask_epi8(_mm_or_si128(ctl, _mm_cmpeq_epi8(v, vsp)));
+		unsigned int nl = _mm_movemask_epi8(_mm_cmpeq_epi8(v, vnl));
+		unsigned int stop = ~ws & 0xFFFF;
+
+		if (stop) {
+			unsigned int pos = __builtin_ctz(stop);
+			*lines += __builtin_popcount(nl & ((1u << pos) - 1));
+			return idx + pos;
+		}
+		*lines += __builtin_popcount(nl);
+		idx += 16;
+	}
+	return space_scalar(buff, len, idx, lines);
+}
+
+__attribute__((target("avx2")))
+static size_t until_avx2(const char *buff, size_t len, size_t idx, char delim) {
+	const __m256i vdelim = _mm256_set1_epi8(delim);
+	const __m256i vnl = _mm256_set1_epi8(NEWLINE);
+	const __m256i vnul = _mm256_setzero_si256();
+
+	while (idx + 32 <= len) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) (buff + idx));
+		__m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, vdelim), _mm256_cmpeq_epi8(v, vnl)), _mm256_cmpeq_epi8(v, vnul));
+		unsigned int mask = _mm256_movemask_epi8(hit);
+		if (mask)
+			return idx + __builtin_ctz(mask);
+		idx += 32;
+	}
+	return until_sse2(buff, len, idx, delim);
+}
+
+__attribute__((target("avx2")))
+static size_t space_avx2(const char *buff, size_t len, size_t idx, int *lines) {
+	const __m256i vsp = _mm256_set1_epi8(' ');
+	const __m256i vnl = _mm256_set1_epi8(NEWLINE);
+	const __m256i vlo = _mm256_set1_epi8('\t' - 1);
+	const __m256i vhi = _mm256_set1_epi8('\r' + 1);
+
+	while (idx + 32 <= len) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) (buff + idx));
+		__m256i ctl = _mm256_and_si256(_mm256_cmpgt_epi8(v, vlo), _mm256_cmpgt_epi8(vhi, v));
+		unsigned int ws = _mm256_movemask_epi8(_mm256_or_si256(ctl, _mm256_cmpeq_epi8(v, vsp)));
+		unsigned int nl = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vnl));
+		unsigned int stop = ~ws;
+
+		if (stop) {
+			unsigned int pos = __builtin_ctz(stop);
+			*lines += __builtin_popcount(nl & ((1u << pos) - 1));
+			return idx + pos;
+		}
+		*lines += __builtin_popcount(nl);
+		idx += 32;
+	}
+	return space_sse2(buff, len, idx, lines);
+}
+
+static const ScanImpl Scan_sse2 = { "sse2", until_sse2, space_sse2 };
+static const ScanImpl Scan_avx2 = { "avx2", until_avx2, space_avx2 };
+
+#endif
+
+// Implementation in use, resolved on first scan.
+static const ScanImpl *Scan_impl = NULL;
+
+// Pick widest implementation supported by cpu.
+static const ScanImpl *scan_detect(void) {
+#ifdef SCAN_X86
+	if (__builtin_cpu_supports("avx2"))
+		return &Scan_avx2;
+	if (__builtin_cpu_supports("sse2"))
+		return &Scan_sse2;
+#endif
+	return &Scan_scalar;
+}
+
+int scan_select(const char *name) {
+	if (!name) {
+		Scan_impl = scan_detect();
+		return 0;
+	}
+
+	if (strcmp(name, "scalar") == 0) {
+		Scan_impl = &Scan_scalar;
+		return 0;
+	}
+#ifdef SCAN_X86
+	if (strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+		Scan_impl = &Scan_sse2;
+		return 0;
+	}
+	if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+		Scan_impl = &Scan_avx2;
+		return 0;
+	}
+#endif
+	return -1;
+}
+
+const char *scan_name(void) {
+	if (!Scan_impl)
+		Scan_impl = scan_detect();
+	return Scan_impl->name;
+}
+
+size_t scan_until(const char *buff, size_t len, size_t idx, char delim) {
+	if (!Scan_impl)
+		Scan_impl = scan_detect();
+	return Scan_impl->until(buff, len, idx, delim);
+}
+
+size_t scan_space(const char *buff, size_t len, size_t idx, int *lines) {
+	if (!Scan_impl)
+		Scan_impl = scan_detect();
+	return Scan_impl->space(buff, len, idx, lines);
+}
@@ -2,11 +2,85 @@
 #include "utils.h"
 #include "conf.h"
 
-SyTable *SyTable_new() {
+// Hash of a label, FNV-1a mixed so consecutive names spread over the low bits.
+static unsigned int sytable_hash(const char *label) {
+	unsigned int hash = string_hash(label, strlen(label));
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	return hash;
+}
+
+// Distance of the entry at pos from its home bucket.
+static size_t sytable_dist(SyTable *sy_table, size_t pos) {
+	return (pos - sy_table->index[pos].hash) & (sy_table->index_cap - 1);
+}
+
+// Find the slot of a label, by pointer if interned otherwise by comparing strings.
+// Returns -1 if not found.
+static long sytable_probe(SyTable *sy_table, const char *label, unsigned int hash, int interned) {
+	size_t mask = sy_table->index_cap - 1;
+	size_t pos = hash & mask;
+
+	for (size_t dist = 0; ; dist++, pos = (pos + 1) & mask) {
+		SyIndexEntry *e = &sy_table->index[pos];
+
+		// Entries closer to home than dist would have been displaced by label.
+		if (!e->slot || sytable_dist(sy_table, pos) < dist)
+			return -1;
+
+		if (e->hash == hash) {
+			char *other = sy_table->symbols[e->slot - 1]->label;
+			if (other == label || (!interned && strcmp(other, label) == 0))
+				return e->slot - 1;
+		}
+	}
+}
+
+// Place an entry, displacing any which are closer to their home bucket.
+static void sytable_place(SyIndexEntry *index, size_t cap, SyIndexEntry e) {
+	size_t mask = cap - 1;
+	size_t pos = e.hash & mask;
+
+	for (size_t dist = 0; index[pos].slot; dist++, pos = (pos + 1) & mask) {
+		size_t other = (pos - index[pos].hash) & mask;
+		if (other < dist) {
+			SyIndexEntry tmp = index[pos];
+			index[pos] = e;
+			e = tmp;
+			dist = other;
+		}
+	}
+	index[pos] = e;
+}
+
+// Double the index, entries are placed again using their stored hash.
+static int sytable_grow_index(SyTable *sy_table) {
+	size_t n_cap = sy_table->index_cap * 2;
+	SyIndexEntry *n_index = calloc(n_cap, sizeof(SyIndexEntry));
+
+	if (null_check(n_index, "sytable grow index"))
+		return -1;
+
+	for (size_t i = 0; i < sy_table->index_cap; i++) {
+		if (sy_table->index[i].slot)
+			sytable_place(n_index, n_cap, sy_table->index[i]);
+	}
+
+	free(sy_table->index);
+	sy_table->index = n_index;
+	sy_table->index_cap = n_cap;
+	return 0;
+}
+
+SyTable *SyTable_new(InternPool *pool) {
 	SyTable *sy_table = malloc(sizeof(SyTable));
+	sy_table->pool = pool;
 	sy_table->sym_cap = INIT_SYTABLE_SIZE;
 	sy_table->sym_ctr = 0;
 	sy_table->symbols = malloc(sy_table->sym_cap * sizeof(Symbol *));
+	sy_table->index_cap = INIT_SYINDEX_SIZE;
+	sy_table->index = calloc(sy_table->index_cap, sizeof(SyIndexEntry));
 	return sy_table;
 }
 
@@ -14,54 +88,68 @@ void SyTable_free(SyTable *sy_table) {
 	if (null_check(sy_table, "sytable free")) return;
 
 	for (size_t i = 0; i < sy_table->sym_ctr; i++) {
-		if (sy_table->symbols[i]->val) {
-			free(sy_table->symbols[i]->val);
-			
-		}
-		free(sy_table->symbols[i]->label);
+		Value_free(&sy_table->symbols[i]->val);
 		free(sy_table->symbols[i]);
 	}
 	
 	free(sy_table->symbols);
+	free(sy_table->index);
 	free(sy_table);
 }
 
 Symbol *Symbol_new(void) {
 	Symbol *sy = malloc(sizeof(Symbol));
-	sy->val = NULL;
+	sy->val = Value_none();
 	return sy;
 }
 
 Symbol *SyTable_get_symbol(SyTable *sy_table, char *sy_name) {
-	if (null_check(sy_table, "sytable free")) return NULL;
-		
-	for (size_t idx = 0; idx < sy_table->sym_ctr; idx++ ) {
-			if (strcmp(sy_table->symbols[idx]->label, sy_name) == 0) {
-				return sy_table->symbols[idx];
-			}
-	}
+	if (null_check(sy_table, "sytable get") || !sy_name) return NULL;
+	
+	long slot = sytable_probe(sy_table, sy_name, sytable_hash(sy_name), 0);
+	return slot < 0 ? NULL : sy_table->symbols[slot];
+}
+
+Symbol *SyTable_find_symbol(SyTable *sy_table, char *sy_name) {
+	if (null_check(sy_table, "sytable find") || !sy_name) return NULL;
 
-	return NULL;
+	long slot = sytable_probe(sy_table, sy_name, sytable_hash(sy_name), 1);
+	return slot < 0 ? NULL : sy_table->symbols[slot];
 }
 
 int SyTable_add_symbol(SyTable *sy_table, char *label, char *val, unsigned int lineno, enum SyType sy_type) {
 	if (null_check(sy_table, "sytable add")) 
 		return -1;
 
-	if (sy_table->sym_cap - sy_table->sym_ctr <= 5) {
+	if (sy_table->sym_ctr == sy_table->sym_cap) {
 		Symbol **sy_new = grow_sy_table(sy_table);
 		if (!sy_new)
 			return 1;
 		sy_table->symbols = sy_new;
 		sy_new = NULL;
 	}
+
+	// Keep load of the index below 7/8.
+	if ((sy_table->sym_ctr + 1) * 8 > sy_table->index_cap * 7 && sytable_grow_index(sy_table))
+		return 1;
 	
+	unsigned int hash = sytable_hash(label);
+	char *interned = InternPool_intern(sy_table->pool, label, strlen(label));
+
+	if (!interned)
+		return 1;
+
 	// Add symbol and increment counter.
 	Symbol *sy = Symbol_new();
-	sy->val = val ? string_dup(val) : NULL;
+	sy->val = val ? Value_str(string_dup(val), 1) : Value_none();
 	sy->lineno = lineno;
-	sy->label = string_dup(label);
+	sy->label = interned;
 	sy->sy_type = sy_type;
+
+	// A duplicate label only takes a slot, lookups still find the first.
+	if (sytable_probe(sy_table, sy->label, hash, 1) < 0)
+		sytable_place(sy_table->index, sy_table->index_cap, (SyIndexEntry) { hash, sy_table->sym_ctr + 1 });
+
 	sy_table->symbols[sy_table->sym_ctr++] = sy;
 	sy = NULL;
 	return 0;
@@ -76,12 +164,39 @@ int SyTable_update_symbol(SyTable *sy_table, char *sy_name, char *sy_n_value) {
 	if (!sy)
 		return -1;
 	
-	// Has it already been set
-	if (sy->val)
-		free(sy->val);
+	// Copy before freeing in case the value is assigned to itself.
+	Value val = Value_str(string_dup(sy_n_value), 1);
+	Value_free(&sy->val);
+	sy->val = val;
+	return 0;
+}
+
+Symbol *SyTable_get_slot(SyTable *sy_table, unsigned int slot) {
+	if (!sy_table || slot >= sy_table->sym_ctr) return NULL;
+	return sy_table->symbols[slot];
+}
+
+int SyTable_lookup_slot(SyTable *sy_table, char *sy_name, unsigned int *slot) {
+	if (null_check(sy_table, "sytable lookup slot") || !sy_name || !slot) return -1;
+
+	long found = sytable_probe(sy_table, sy_name, sytable_hash(sy_name), 0);
+	if (found < 0)
+		return -1;
+
+	*slot = (unsigned int) found;
+	return 0;
+}
+
+int SyTable_update_slot(SyTable *sy_table, unsigned int slot, Value val) {
+	Symbol *sy = SyTable_get_slot(sy_table, slot);
+
+	if (!sy) {
+		Value_free(&val);
+		return -1;
+	}
 
-	// Reassign to new value.
-	sy->val = string_dup(sy_n_value);
+	Value_free(&sy->val);
+	sy->val = val;
 	return 0;
 }
 
@@ -92,19 +207,23 @@ void SyTable_print_symbols(SyTable *sy_table) {
 	printf("** Symbol Table Dump **\n");
 	printf("--------------------------------------\n");
 	char *t = NULL;
+	VString buff = VString_new();
 	for (size_t i = 0; i < sy_table->sym_ctr; i++) {
 		if (sy_table->symbols[i]->sy_type == E_IDN_TYPE)
 			t = "Variable";
 		else
 			t = "Group Name";
-		char *sy_val = sy_table->symbols[i]->val ? sy_table->symbols[i]->val : "Undefined";
+		Value *val = &sy_table->symbols[i]->val;
+		char *sy_val = val->type == E_NONE_VALUE ? "Undefined" : Value_to_string(val, &buff);
 		printf("--> Name : %s | Type: %s  | Value: %s \n", sy_table->symbols[i]->label, t, sy_val);
 	}
+	VString_free(&buff);
 }
 
 Symbol **grow_sy_table(SyTable *sy_table) {
 	if (null_check(sy_table, "sytable grow")) return NULL;
-    sy_table->sym_cap *= 2;
-    Symbol **sy_new = realloc(sy_table->symbols, sizeof(Symbol *) * sy_table->sym_cap);	
+    Symbol **sy_new = realloc(sy_table->symbols, sizeof(Symbol *) * sy_table->sym_cap * 2);
+    if (sy_new)
+        sy_table->sym_cap *= 2;
     return sy_new;
 }
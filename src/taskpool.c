@@ -0,0 +1,291 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "taskpool.h"
+#include "utils.h"
+
+#define INIT_DEQUE_SIZE 16
+
+typedef struct {
+	TaskFn fn;
+	void *arg;
+} Task;
+
+/**
+ * @brief Deque of a worker, a ring of ctr tasks starting at head.
+ *
+ * The owner takes from the back and thieves from the front, both under lock.
+ * stats are only written by the owner.
+ */
+typedef struct {
+	TaskPool *pool;
+	size_t idx;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	Task *tasks;
+	size_t head;
+	size_t ctr;
+	size_t cap;
+	unsigned int seed;
+	TaskPoolStats stats;
+} TaskDeque;
+
+/**
+ * @brief Pool of workers.
+ *
+ * There is a deque for each of deque_ctr workers asked for, the first worker_ctr
+ * of which started. queued counts tasks sitting in deques and pending tasks not
+ * done yet, both changed atomically. lock only guards sleeping on wake and waiting
+ * on done.
+ */
+struct TaskPool {
+	TaskDeque *deques;
+	size_t deque_ctr;
+	size_t worker_ctr;
+	size_t next;
+	size_t queued;
+	size_t pending;
+	int stop;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t done;
+};
+
+// Take the task at the back of a worker's own deque.
+static int taskpool_pop(TaskDeque *deque, Task *task) {
+	int found = 0;
+
+	pthread_mutex_lock(&deque->lock);
+	if (deque->ctr) {
+		deque->ctr--;
+		*task = deque->tasks[(deque->head + deque->ctr) % deque->cap];
+		found = 1;
+	}
+	pthread_mutex_unlock(&deque->lock);
+
+	if (found)
+		__atomic_fetch_sub(&deque->pool->queued, 1, __ATOMIC_RELAXED);
+	return found;
+}
+
+// Take the task at the front of another worker's deque, trying each once from
+// a random one. Busy deques are skipped rather than waited on.
+static int taskpool_steal(TaskDeque *self, Task *task) {
+	TaskPool *pool = self->pool;
+	size_t worker_ctr = __atomic_load_n(&pool->worker_ctr, __ATOMIC_ACQUIRE);
+
+	// xorshift, each worker has its own seed.
+	self->seed ^= self->seed << 13;
+	self->seed ^= self->seed >> 17;
+	self->seed ^= self->seed << 5;
+
+	for (size_t i = 0; i < worker_ctr; i++) {
+		TaskDeque *victim = &pool->deques[(self->seed + i) % worker_ctr];
+		int found = 0;
+
+		if (victim == self || pthread_mutex_trylock(&victim->lock) != 0)
+			continue;
+
+		if (victim->ctr) {
+			*task = victim->tasks[victim->head];
+			victim->head = (victim->head + 1) % victim->cap;
+			victim->ctr--;
+			found = 1;
+		}
+		pthread_mutex_unlock(&victim->lock);
+
+		if (found) {
+			__atomic_fetch_sub(&pool->queued, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&self->stats.stolen, 1, __ATOMIC_RELAXED);
+			return 1;
+		}
+		__atomic_fetch_add(&self->stats.steal_fails, 1, __ATOMIC_RELAXED);
+	}
+
+	return 0;
+}
+
+// Run tasks until the pool is stopped and nothing is left, sleeping while idle.
+static void *taskpool_worker(void *arg) {
+	TaskDeque *self = arg;
+	TaskPool *pool = self->pool;
+	Task task;
+
+	for (;;) {
+		if (taskpool_pop(self, &task) || taskpool_steal(self, &task)) {
+			task.fn(task.arg, self->idx);
+			__atomic_fetch_add(&self->stats.run, 1, __ATOMIC_RELAXED);
+
+			// Last task done wakes the waiters, lock is taken so none misses it.
+			if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+				pthread_mutex_lock(&pool->lock);
+				pthread_cond_broadcast(&pool->done);
+				pthread_mutex_unlock(&pool->lock);
+			}
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->lock);
+		while (!__atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE) && !pool->stop)
+			pthread_cond_wait(&pool->wake, &pool->lock);
+		int stop = pool->stop && !__atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE);
+		pthread_mutex_unlock(&pool->lock);
+
+		if (stop)
+			break;
+	}
+
+	return NULL;
+}
+
+TaskPool *TaskPool_new(size_t workers) {
+	if (!workers)
+		workers = 1;
+
+	TaskPool *pool = calloc(1, sizeof(TaskPool));
+	if (null_check(pool, "taskpool new"))
+		return NULL;
+
+	pool->deques = calloc(workers, sizeof(TaskDeque));
+	if (null_check(pool->deques, "taskpool new")) {
+		free(pool);
+		return NULL;
+	}
+
+	pool->deque_ctr = workers;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->wake, NULL);
+	pthread_cond_init(&pool->done, NULL);
+
+	// Every deque is set up before any worker may look at it.
+	for (size_t i = 0; i < workers; i++) {
+		pool->deques[i].pool = pool;
+		pool->deques[i].idx = i;
+		pool->deques[i].seed = (unsigned int) i * 2654435761u + 1;
+		pthread_mutex_init(&pool->deques[i].lock, NULL);
+	}
+
+	// Workers which fail to start are left out, the rest only steal from those before them.
+	for (size_t i = 0; i < workers; i++) {
+		if (pthread_create(&pool->deques[i].thread, NULL, taskpool_worker, &pool->deques[i]) != 0)
+			break;
+		__atomic_store_n(&pool->worker_ctr, i + 1, __ATOMIC_RELEASE);
+	}
+
+	if (!pool->worker_ctr) {
+		TaskPool_free(pool);
+		return NULL;
+	}
+
+	return pool;
+}
+
+int TaskPool_submit(TaskPool *pool, TaskFn fn, void *arg) {
+	if (null_check(pool, "taskpool submit") || null_check((void *) fn, "taskpool submit")) return -1;
+
+	size_t idx = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED) % pool->worker_ctr;
+	TaskDeque *deque = &pool->deques[idx];
+
+	pthread_mutex_lock(&deque->lock);
+	if (deque->ctr == deque->cap) {
+		size_t n_cap = deque->cap ? deque->cap * 2 : INIT_DEQUE_SIZE;
+		Task *n_tasks = malloc(n_cap * sizeof(Task));
+
+		if (null_check(n_tasks, "taskpool submit")) {
+			pthread_mutex_unlock(&deque->lock);
+			return -1;
+		}
+
+		// Unwrap the ring so it starts at 0 again.
+		for (size_t i = 0; i < deque->ctr; i++)
+			n_tasks[i] = deque->tasks[(deque->head + i) % deque->cap];
+		free(deque->tasks);
+		deque->tasks = n_tasks;
+		deque->head = 0;
+		deque->cap = n_cap;
+	}
+
+	deque->tasks[(deque->head + deque->ctr) % deque->cap] = (Task) { fn, arg };
+	deque->ctr++;
+	__atomic_fetch_add(&pool->pending, 1, __ATOMIC_ACQ_REL);
+	__atomic_fetch_add(&pool->queued, 1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&deque->lock);
+
+	pthread_mutex_lock(&pool->lock);
+	pthread_cond_signal(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+	return 0;
+}
+
+void TaskPool_wait(TaskPool *pool) {
+	if (!pool) return;
+
+	pthread_mutex_lock(&pool->lock);
+	while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE))
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+size_t TaskPool_workers(TaskPool *pool) {
+	return pool ? __atomic_load_n(&pool->worker_ctr, __ATOMIC_ACQUIRE) : 0;
+}
+
+void TaskPool_stats(TaskPool *pool, TaskPoolStats *total, TaskPoolStats *per_worker) {
+	if (null_check(pool, "taskpool stats") || null_check(total, "taskpool stats")) return;
+
+	*total = (TaskPoolStats) { 0, 0, 0 };
+	for (size_t i = 0; i < pool->worker_ctr; i++) {
+		TaskPoolStats *stats = &pool->deques[i].stats;
+		TaskPoolStats w = {
+			__atomic_load_n(&stats->run, __ATOMIC_RELAXED),
+			__atomic_load_n(&stats->stolen, __ATOMIC_RELAXED),
+			__atomic_load_n(&stats->steal_fails, __ATOMIC_RELAXED)
+		};
+
+		total->run += w.run;
+		total->stolen += w.stolen;
+		total->steal_fails += w.steal_fails;
+		if (per_worker)
+			per_worker[i] = w;
+	}
+}
+
+void TaskPool_print_stats(TaskPool *pool, FILE *out) {
+	size_t worker_ctr = TaskPool_workers(pool);
+	TaskPoolStats total = { 0, 0, 0 };
+	TaskPoolStats *per_worker = worker_ctr ? malloc(worker_ctr * sizeof(TaskPoolStats)) : NULL;
+
+	if (pool)
+		TaskPool_stats(pool, &total, per_worker);
+
+	fprintf(out, "taskpool: %zu workers, %zu run, %zu stolen, %zu steal fails\n",
+		worker_ctr, total.run, total.stolen, total.steal_fails);
+	for (size_t i = 0; per_worker && i < worker_ctr; i++)
+		fprintf(out, "  worker %zu: %zu run, %zu stolen, %zu steal fails\n",
+			i, per_worker[i].run, per_worker[i].stolen, per_worker[i].steal_fails);
+
+	free(per_worker);
+}
+
+void TaskPool_free(TaskPool *pool) {
+	if (!pool) return;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (size_t i = 0; i < pool->worker_ctr; i++)
+		pthread_join(pool->deques[i].thread, NULL);
+
+	// Workers drained their deques before stopping.
+	for (size_t i = 0; i < pool->deque_ctr; i++) {
+		pthread_mutex_destroy(&pool->deques[i].lock);
+		free(pool->deques[i].tasks);
+	}
+
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->wake);
+	pthread_cond_destroy(&pool->done);
+	free(pool->deques);
+	free(pool);
+}
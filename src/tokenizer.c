@@ -1,294 +1,466 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "utils.h"
 #include "tokenizer.h"
 #include "tokens.h"
-#include "vstring.h"
+#include "scan.h"
+
+/**
+ * @brief Lexer state carried from one range of source to the next.
+ * 
+ * Only an open group survives a newline, strings and comments always end at one.
+ */
+typedef struct {
+	size_t pos;
+	size_t start;
+	int lineno;
+	int brlock;
+	int error;
+} LexState;
+
+/**
+ * @brief Range of source tokenized by a worker thread into its own TokenMgr and InternPool.
+ */
+typedef struct {
+	size_t begin;
+	size_t end;
+	TokenMgr *tok_mgr;
+	LexState st;
+} LexChunk;
+
+/**
+ * @brief Chunks shared by worker threads, next is claimed atomically.
+ */
+typedef struct {
+	const char *buff;
+	size_t len;
+	LexChunk *chunks;
+	size_t chunk_ctr;
+	size_t next;
+} LexJob;
 
 // Ensure a variable confirms to naming specifications.
-static int is_legal_variable(char *var) {
-	if (!var) return 0;
-	return var[0] != MINUS && !isdigit(var[0]);
+static int is_legal_variable(char c) {
+	return c != MINUS && !char_is(c, CF_DIGIT);
 }
 
-int TokenMgr_build_tokens(char *buff, TokenMgr *tokmgr) {
-	if (null_check(buff, "Tokenizer build tokens") || null_check(tokmgr, "Tokenizer build tokens"))
-		return -1;
+// Stop characters when recovering from an unknown character formation.
+static int is_unknown_stop(char c) {
+	return c == COMMENT || c == LBRACE || c == RBRACE || c == '\0' 
+		|| c == DQUOTE || c == VAR || c == NEWLINE || c == EQUAL;
+}
 
+// Tokenize buff from st->pos up to end, which is the end of buff or just after a newline.
+static void tokenize_range(const char *buff, size_t end, TokenMgr *tokmgr, LexState *st) {
 	// Each character in buffer.
 	char c;
-	// Reusable storage to hold combined chars. 
-	VString store = VString_new();
+	// Start of the lexeme currently being read.
+	size_t start = st->pos;
 	// Buff iterator.
-	size_t bidx = 0;
+	size_t bidx = st->pos;
+	// Scanners never read past end.
+	size_t len = end;
 	// Error code.
 	int error = 0;
 	// Track line no.
-	int lineno = 1;
-	int brlock = 0;
+	int lineno = st->lineno;
+	int brlock = st->brlock;
 
-	while (buff[bidx] != '\0' && !error) {
+	while (bidx < end && buff[bidx] != '\0' && !error) {
 		c = buff[bidx];
-		
-		VString_set(&store, "");
-
-		// Spaces and irrelevant characters.
-		if (c == COMMENT) {
-			while (c != NEWLINE && c != '\0') {
-				c = buff[++bidx];
-			}
-			continue;
-		}
-		else if (isspace(c) && c != NEWLINE) {
-			while (isspace(c) && c != NEWLINE) {
-				c = buff[++bidx];
-			}
-			continue;
-		}
-		else if (c == NEWLINE) {
-			lineno++;
-			bidx++;
-			continue;
-		}
-		// Simple literals.
-		else if (c == LBRACKET) {
-			TokenMgr_add_token(tokmgr, E_LBRACKET_TOKEN, "[", lineno);
-			bidx++;
-		}
-		else if (c == LBRACE) {
-			TokenMgr_add_token(tokmgr, E_LBRACE_TOKEN, "{", lineno);
-			brlock = 1;
-			bidx++;
-		}
-		else if (c == RBRACE) {
-			brlock = 0;
-			TokenMgr_add_token(tokmgr, E_RBRACE_TOKEN, "}", lineno);
-			bidx++;
-		}
-		else if (c == RBRACKET) {
-			TokenMgr_add_token(tokmgr, E_RBRACKET_TOKEN, "]", lineno);
-			bidx++;
-		}
-		else if (c == LPAREN) {
-			TokenMgr_add_token(tokmgr, E_LPAREN_TOKEN, "(", lineno);
-			bidx++;
-		}
-		else if (c == RPAREN) {
-			TokenMgr_add_token(tokmgr, E_RPAREN_TOKEN, ")", lineno);
-			bidx++;
-		}
-		else if (c == PLUS) {
-			TokenMgr_add_token(tokmgr, E_PLUS_TOKEN, "+", lineno);
-			bidx++;
-		} 
-		else if (c ==  MINUS) {
-			TokenMgr_add_token(tokmgr, E_MINUS_TOKEN, "-", lineno);
-			bidx++;
-		} 
-		else if (c ==  ASTERISK) {
-			TokenMgr_add_token(tokmgr, E_ASTERISK_TOKEN, "*", lineno);
-			bidx++;
-		} 
-		else if (c == FSLASH) {
-			TokenMgr_add_token(tokmgr, E_FSLASH_TOKEN, "/", lineno);
-			bidx++;
-		}
-		else if (c == COMMA) {
-			TokenMgr_add_token(tokmgr, E_COMMA_TOKEN, ",", lineno);
-			bidx++;
-		}
-		// Compound literals.
-		else if (c == BTICK) {
-			c = buff[++bidx];
-			while (c != BTICK && c != '\0' && c != NEWLINE) {
-				VString_pushc(&store, c);
-				c = buff[++bidx];
-			}
-			if (c != BTICK) {
-				error = 1;
-				continue;
-			}
-			TokenMgr_add_token(tokmgr, E_MIXSTR_TOKEN, store.str, lineno);
-			bidx++;
-		}
-		else if (c == BANG) {
-			if (buff[bidx+1] == EQUAL) {
-				TokenMgr_add_token(tokmgr, E_NEQUAL_TOKEN, "!=", lineno);
+		start = bidx;
+
+		switch (char_class(c)) {
+			// Spaces and irrelevant characters.
+			case E_CC_COMMENT:
+				bidx = scan_until(buff, len, bidx, NEWLINE);
+				break;
+			case E_CC_SPACE:
+			case E_CC_NEWLINE:
+				// Lone separators are by far the most common, don't bother scanning for those.
+				if (char_class(buff[bidx+1]) != E_CC_SPACE && buff[bidx+1] != NEWLINE) {
+					lineno += c == NEWLINE;
+					bidx++;
+					break;
+				}
+				bidx = scan_space(buff, len, bidx, &lineno);
+				break;
+			// Simple literals.
+			case E_CC_SINGLE:
+				TokenMgr_add_token(tokmgr, Char_token[(unsigned char) c], start, 1, lineno);
 				bidx++;
-			}
-			else {
-				TokenMgr_add_token(tokmgr, E_NOT_TOKEN, "!", lineno);
-			}
-			bidx++;
-		}
-		else if (c == LESSTHAN) {
-			if (buff[bidx+1] == EQUAL) {
-				TokenMgr_add_token(tokmgr, E_LESSTHANEQ_TOKEN, "<=", lineno);
+				break;
+			case E_CC_LBRACE:
+				TokenMgr_add_token(tokmgr, E_LBRACE_TOKEN, start, 1, lineno);
+				brlock = 1;
 				bidx++;
-			}
-			else {
-				TokenMgr_add_token(tokmgr, E_LESSTHAN_TOKEN, "<", lineno);
-			}
-			bidx++;
-		}
-		else if (c == GREATERTHAN) {
-			switch(buff[++bidx]) {
-				case EQUAL:
-					TokenMgr_add_token(tokmgr, E_GREATERTHANEQ_TOKEN, ">=", lineno);
-					break;
-				case LESSTHAN:
-					TokenMgr_add_token(tokmgr, E_BETWEEN_TOKEN, "><", lineno);
+				break;
+			case E_CC_RBRACE:
+				brlock = 0;
+				TokenMgr_add_token(tokmgr, E_RBRACE_TOKEN, start, 1, lineno);
+				bidx++;
+				break;
+			// Compound literals.
+			case E_CC_BANG:
+				if (buff[bidx+1] == EQUAL) {
+					TokenMgr_add_token(tokmgr, E_NEQUAL_TOKEN, start, 2, lineno);
+					bidx++;
+				}
+				else {
+					TokenMgr_add_token(tokmgr, E_NOT_TOKEN, start, 1, lineno);
+				}
+				bidx++;
+				break;
+			case E_CC_LESSTHAN:
+				if (buff[bidx+1] == EQUAL) {
+					TokenMgr_add_token(tokmgr, E_LESSTHANEQ_TOKEN, start, 2, lineno);
+					bidx++;
+				}
+				else {
+					TokenMgr_add_token(tokmgr, E_LESSTHAN_TOKEN, start, 1, lineno);
+				}
+				bidx++;
+				break;
+			case E_CC_GREATERTHAN:
+				switch(buff[bidx+1]) {
+					case EQUAL:
+						TokenMgr_add_token(tokmgr, E_GREATERTHANEQ_TOKEN, start, 2, lineno);
+						bidx++;
+						break;
+					case LESSTHAN:
+						TokenMgr_add_token(tokmgr, E_BETWEEN_TOKEN, start, 2, lineno);
+						bidx++;
+						break;
+					default:
+						TokenMgr_add_token(tokmgr, E_GREATERTHAN_TOKEN, start, 1, lineno);
+						break;
+				}
+				bidx++;
+				break;
+			case E_CC_EQUAL:
+				if (buff[bidx+1] == EQUAL) {
+					TokenMgr_add_token(tokmgr, E_EEQUAL_TOKEN, start, 2, lineno);
+					bidx++;
+				}
+				else {
+					TokenMgr_add_token(tokmgr, E_EQUAL_TOKEN, start, 1, lineno);
+				}	
+				bidx++;
+				break;
+			case E_CC_BTICK:
+				start = bidx + 1;
+				bidx = scan_until(buff, len, start, BTICK);
+				c = buff[bidx];
+				if (c != BTICK) {
+					error = 1;
 					break;
-				default:
-					bidx--;
-					TokenMgr_add_token(tokmgr, E_GREATERTHAN_TOKEN, ">", lineno);
+				}
+				TokenMgr_add_token(tokmgr, E_MIXSTR_TOKEN, start, bidx - start, lineno);
+				bidx++;
+				break;
+			case E_CC_DQUOTE:
+				start = bidx + 1;
+				bidx = scan_until(buff, len, start, DQUOTE);
+				c = buff[bidx];
+				// Ensure last read char is closing quote.
+				if (c != DQUOTE) {
+					error = 1;
 					break;
-			}
-			bidx++;
-		}
-		else if (c ==  EQUAL) {
-			if (buff[bidx+1] == EQUAL) {
-				TokenMgr_add_token(tokmgr, E_EEQUAL_TOKEN, "==", lineno);
+				}
+				TokenMgr_add_token(tokmgr, E_STRING_TOKEN, start, bidx - start, lineno);
 				bidx++;
-			}
-			else {
-				TokenMgr_add_token(tokmgr, E_EQUAL_TOKEN, "=", lineno);
-			}	
-			bidx++;
-		}
-		
-		else if (c == DQUOTE) {
-			c = buff[++bidx];
-			while (c != DQUOTE && c != '\0' && c != NEWLINE) {
-				VString_pushc(&store, c);
+				break;
+			case E_CC_VAR:
+				c = buff[++bidx];
+				start = bidx;
+
+				while (char_is(c, CF_IDENT)) {
+					c = buff[++bidx];
+				}
+
+				// Prevent empty variables e.g $
+				if (bidx == start || !is_legal_variable(buff[start])) {
+					error = 1;
+					break;
+				}
+
+				TokenMgr_add_token(tokmgr, E_IDENTIFIER_TOKEN, start, bidx - start, lineno);
+				break;
+			case E_CC_DIGIT:
+				while (char_is(c, CF_DIGIT)) {
+					c = buff[++bidx];
+				}
+				TokenMgr_add_token(tokmgr, E_INTEGER_TOKEN, start, bidx - start, lineno);
+				break;
+			case E_CC_ALPHA:
+				if (brlock) {
+					while (c != LBRACE && c != RBRACE && c != NEWLINE && c != '\0') {
+						c = buff[++bidx];	
+					}
+					TokenMgr_add_token(tokmgr, E_STRING_TOKEN, start, bidx - start, lineno);
+				}
+				else {
+					while (char_is(c, CF_IDENT)) {
+						c = buff[++bidx];
+					}
+					TokenMgr_add_token(tokmgr, E_KEYWORD_TOKEN, start, bidx - start, lineno);
+					tokmgr->toks[tokmgr->tok_ctr-1].kwid = keyword_lookup(buff + start, bidx - start);
+				}
+				break;
+			default:
 				c = buff[++bidx];
-			}
-			// Ensure last read char is closing quote.
-			if (c != DQUOTE) {
+				while (!is_unknown_stop(c)) {
+					c = buff[++bidx];
+				}
 				error = 1;
-				continue;
-			}
-			TokenMgr_add_token(tokmgr, E_STRING_TOKEN, store.str, lineno);
-			bidx++;
+				break;
 		}
-		else if (c == VAR) {
-			c = buff[++bidx];
+	}
 
-			while (is_valid_identifier(c)) {
-				VString_pushc(&store, c);
-				c = buff[++bidx];
-			}
+	st->pos = bidx;
+	st->start = start;
+	st->lineno = lineno;
+	st->brlock = brlock;
+	st->error = error;
+}
 
-			// Prevent empty variables e.g $
-			if (store.str_size < 1 || !is_legal_variable(store.str)) {
-				error = 1;
-				bidx++;
-				continue;
-			}
+// Terminate the token stream and report where lexing stopped on error.
+static int tokenize_finish(const char *buff, TokenMgr *tokmgr, LexState *st) {
+	TokenMgr_add_token(tokmgr, E_EOF_TOKEN, st->pos, 0, 0);
+
+	if (st->error)
+		printf("Token error: unknown '%.*s' found in line %d\n", (int) (st->pos - st->start), buff + st->start, st->lineno);
+
+	return st->error;
+}
+
+int TokenMgr_build_tokens(const char *buff, TokenMgr *tokmgr) {
+	if (null_check((void *) buff, "Tokenizer build tokens") || null_check(tokmgr, "Tokenizer build tokens"))
+		return -1;
+
+	LexState st = { 0, 0, 1, 0, 0 };
+
+	tokmgr->src = buff;
+	tokmgr->src_len = strlen(buff);
+	tokenize_range(buff, tokmgr->src_len, tokmgr, &st);
+	return tokenize_finish(buff, tokmgr, &st);
+}
+
+// Append tokens of a chunk tokenized on its own, remapping string ids and line numbers.
+static int tokens_append(TokenMgr *tokmgr, TokenMgr *chunk, int lineno) {
+	InternPool *pool = chunk->pool;
+	unsigned int *remap = malloc((pool->str_ctr + 1) * sizeof(unsigned int));
 
-			TokenMgr_add_token(tokmgr, E_IDENTIFIER_TOKEN, store.str, lineno);
+	if (null_check(remap, "Tokenizer append"))
+		return 1;
+
+	for (size_t id = 0; id < pool->str_ctr; id++) {
+		remap[id] = InternPool_add(tokmgr->pool, pool->strs[id], pool->lens[id]);
+		if (remap[id] == INTERN_ERROR_ID) {
+			free(remap);
+			return 1;
 		}
-		else if (isdigit(c)) {
-			while (isdigit(c)) {
-				VString_pushc(&store, c);
-				c = buff[++bidx];
-			}
-			TokenMgr_add_token(tokmgr, E_INTEGER_TOKEN, store.str, lineno);
+	}
+
+	while (tokmgr->tok_cap - tokmgr->tok_ctr <= chunk->tok_ctr + 5) {
+		if (!grow_tokens(tokmgr)) {
+			free(remap);
+			return 1;
 		}
-		else if (isalpha(c)) {
-			if (brlock) {
-				while (c != LBRACE && c != RBRACE && c != NEWLINE) {
-					VString_pushc(&store, c);
-					c = buff[++bidx];	
-				}
-			}
-			else {
-				while (is_valid_identifier(c)) {
-					VString_pushc(&store, c);
-					c = buff[++bidx];
-				}
-			}
-			if (brlock)
-				TokenMgr_add_token(tokmgr, E_STRING_TOKEN, store.str, lineno);
-			else
-				TokenMgr_add_token(tokmgr, E_KEYWORD_TOKEN, store.str, lineno);
+	}
+
+	for (size_t i = 0; i < chunk->tok_ctr; i++) {
+		Token *tok = &tokmgr->toks[tokmgr->tok_ctr++];
+		*tok = chunk->toks[i];
+		tok->lineno += lineno;
+		if (!token_literal(tok->type))
+			tok->sid = remap[tok->sid];
+	}
+
+	free(remap);
+	return 0;
+}
+
+// Tokenize chunks until none are left, run by every thread.
+static void *tokenize_worker(void *arg) {
+	LexJob *job = arg;
+	size_t idx = 0;
+
+	while ((idx = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->chunk_ctr) {
+		LexChunk *chunk = &job->chunks[idx];
+
+		// Chunks start with no open group at line 0, verified while stitching.
+		chunk->tok_mgr = TokenMgr_new(InternPool_new());
+		chunk->tok_mgr->src = job->buff;
+		chunk->tok_mgr->src_len = job->len;
+		chunk->st = (LexState) { chunk->begin, chunk->begin, 0, 0, 0 };
+		tokenize_range(job->buff, chunk->end, chunk->tok_mgr, &chunk->st);
+	}
+
+	return NULL;
+}
+
+// Pick a chunk boundary just after a newline at or after pos.
+static size_t chunk_boundary(const char *buff, size_t len, size_t pos) {
+	const char *nl = memchr(buff + pos, NEWLINE, len - pos);
+	if (!nl)
+		return len;
+
+	pos = nl - buff + 1;
+
+	// Closing brace ahead of an opening one means pos is likely inside a group, move past it.
+	for (size_t i = pos; i < len && i < pos + PARTOK_BRACE_WINDOW; i++) {
+		if (buff[i] == LBRACE)
+			break;
+		if (buff[i] == RBRACE) {
+			nl = memchr(buff + i, NEWLINE, len - i);
+			return nl ? (size_t) (nl - buff + 1) : len;
+		}
+	}
+
+	return pos;
+}
+
+int TokenMgr_build_tokens_parallel(const char *buff, TokenMgr *tokmgr, unsigned int workers) {
+	if (null_check((void *) buff, "Tokenizer build tokens") || null_check(tokmgr, "Tokenizer build tokens"))
+		return -1;
+
+	size_t len = strlen(buff);
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (!workers)
+		workers = cores > 0 ? cores : 1;
+
+	// Not worth the threads, tokenize as usual.
+	if (workers < 2 || len < 2 * PARTOK_MIN_CHUNK)
+		return TokenMgr_build_tokens(buff, tokmgr);
+
+	size_t chunk_cap = (size_t) workers * PARTOK_CHUNKS_PER_WORKER;
+	if (chunk_cap > len / PARTOK_MIN_CHUNK)
+		chunk_cap = len / PARTOK_MIN_CHUNK;
+
+	LexJob job = { buff, len, calloc(chunk_cap, sizeof(LexChunk)), 0, 0 };
+	pthread_t *threads = malloc(workers * sizeof(pthread_t));
+	unsigned int thread_ctr = 0;
+
+	if (null_check(job.chunks, "Tokenizer chunks") || null_check(threads, "Tokenizer threads")) {
+		free(job.chunks);
+		free(threads);
+		return TokenMgr_build_tokens(buff, tokmgr);
+	}
+
+	// Split at newlines, chunks never end mid line.
+	for (size_t pos = 0; pos < len && job.chunk_ctr < chunk_cap; ) {
+		size_t target = len / chunk_cap * (job.chunk_ctr + 1);
+		size_t end = job.chunk_ctr + 1 == chunk_cap ? len : chunk_boundary(buff, len, target > pos ? target : pos);
+		job.chunks[job.chunk_ctr].begin = pos;
+		job.chunks[job.chunk_ctr++].end = end;
+		pos = end;
+	}
+
+	// Resolve scanner before threads race on it.
+	scan_name();
+
+	// Calling thread works too, any thread which fails to start just leaves more for the rest.
+	for (unsigned int i = 1; i < workers; i++) {
+		if (pthread_create(&threads[thread_ctr], NULL, tokenize_worker, &job) == 0)
+			thread_ctr++;
+	}
+
+	tokenize_worker(&job);
+
+	for (unsigned int i = 0; i < thread_ctr; i++)
+		pthread_join(threads[i], NULL);
+
+	/**
+	 * Stitch chunks in order. A chunk is only valid if the previous one ended outside
+	 * of a group, otherwise (or if it hit an error) it's tokenized again serially
+	 * carrying the state over, which also reports the error with the right line.
+	 */
+	LexState st = { 0, 0, 1, 0, 0 };
+	tokmgr->src = buff;
+	tokmgr->src_len = len;
+
+	for (size_t i = 0; i < job.chunk_ctr && !st.error; i++) {
+		LexChunk *chunk = &job.chunks[i];
+
+		if (!st.brlock && !chunk->st.error && !tokens_append(tokmgr, chunk->tok_mgr, st.lineno)) {
+			st.pos = chunk->st.pos;
+			st.lineno += chunk->st.lineno;
+			st.brlock = chunk->st.brlock;
 		}
 		else {
-			VString_pushc(&store, c);
-			c = buff[++bidx];
-			while (c != COMMENT && c != LBRACE && c != RBRACE && c != '\0' \
-				&& c != DQUOTE && c != VAR & c != NEWLINE && c!= EQUAL) {
-				VString_pushc(&store, c);
-				c = buff[++bidx];
-			}
-			error = 1;
+			st.pos = chunk->begin;
+			tokenize_range(buff, chunk->end, tokmgr, &st);
 		}
 	}
 
-	TokenMgr_add_token(tokmgr, E_EOF_TOKEN, "TAIL", 0);
-
-	if (error)
-		printf("Token error: unknown '%s' found in line %d\n", store.str, lineno);
+	for (size_t i = 0; i < job.chunk_ctr; i++) {
+		InternPool_free(job.chunks[i].tok_mgr->pool);
+		TokenMgr_free(job.chunks[i].tok_mgr);
+	}
 
-	VString_free(&store);
-	return error;
+	free(job.chunks);
+	free(threads);
+	return tokenize_finish(buff, tokmgr, &st);
 }
 
-TokenMgr *TokenMgr_new(void) {
+TokenMgr *TokenMgr_new(InternPool *pool) {
 	TokenMgr *tok_mgr = malloc(sizeof(TokenMgr));
-	tok_mgr->toks_tail = NULL;
-	tok_mgr->toks_head = NULL;
+	tok_mgr->pool = pool;
+	tok_mgr->src = NULL;
+	tok_mgr->src_len = 0;
 	tok_mgr->tok_ctr = 0;
 	tok_mgr->tok_cap = INIT_TOKMGR_TOKS_SIZE;
-	tok_mgr->toks_curr = malloc(tok_mgr->tok_cap * sizeof(Token*));	
+	tok_mgr->toks = malloc(tok_mgr->tok_cap * sizeof(Token));	
+	tok_mgr->toks_curr = tok_mgr->toks;
 	return tok_mgr;
 }
 
-int TokenMgr_add_token(TokenMgr *tok_mgr, TokenType tok_type, char *tok_val, int tok_lineno) {
+int TokenMgr_add_token(TokenMgr *tok_mgr, TokenType tok_type, size_t tok_offset, size_t tok_length, int tok_lineno) {
 	if (null_check(tok_mgr, "Tokenizer add token")) return -1;
 
-	// Get string length of value.
-	size_t tok_val_length = strlen(tok_val);
-	
-	// Create temp token on heap.
-	Token *tmp = malloc(sizeof(Token));	
-	tmp->value = calloc(tok_val_length+1, sizeof(char));
-	tmp->type = tok_type;
-	strcpy(tmp->value, tok_val);
-	tmp->lineno = tok_lineno;
-
 	// Determine if we need more room in toks.
 	if (tok_mgr->tok_cap - tok_mgr->tok_ctr <= 5) {
-		tok_mgr->toks_curr = grow_curr_tokens(tok_mgr);
+		Token *toks_new = grow_tokens(tok_mgr);
 
 		// Make sure grow was succesful.
-		if (!tok_mgr->toks_curr)
+		if (!toks_new)
 			return 1;
 	}	
 
-	tok_mgr->toks_curr[tok_mgr->tok_ctr++] = tmp;
-	tok_mgr->toks_tail = tmp;
-
-	// Only set head if not already defined.
-	if (!tok_mgr->toks_head)
-		tok_mgr->toks_head = tmp;
+	unsigned int sid = token_literal(tok_type) ? 0 : InternPool_add(tok_mgr->pool, tok_mgr->src + tok_offset, tok_length);
+	if (sid == INTERN_ERROR_ID)
+		return 1;
 
+	Token *tmp = &tok_mgr->toks[tok_mgr->tok_ctr++];
+	tmp->type = tok_type;
+	tmp->kwid = E_KW_NONE;
+	tmp->offset = tok_offset;
+	tmp->length = tok_length;
+	tmp->lineno = tok_lineno;
+	tmp->sid = sid;
 	return 0;
 }
 
+char *TokenMgr_token_value(TokenMgr *tok_mgr, Token *tok) {
+	if (null_check(tok_mgr, "Tokenizer token value") || null_check(tok, "Tokenizer token value")) return NULL;
+	
+	char *literal = token_literal(tok->type);
+	return literal ? literal : InternPool_get(tok_mgr->pool, tok->sid);
+}
+
 Token *TokenMgr_peek_token(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "Tokenizer peek token")) return NULL;
 	
 	// If on last token then just return.
-	if (*tok_mgr->toks_curr == tok_mgr->toks_tail)
-		return *tok_mgr->toks_curr;
+	if (TokenMgr_is_last_token(tok_mgr))
+		return tok_mgr->toks_curr;
 
-	tok_mgr->toks_curr++;
-	Token *next = *tok_mgr->toks_curr;
-	tok_mgr->toks_curr--;
-	return next;
+	return tok_mgr->toks_curr + 1;
 }
 
 void TokenMgr_print_tokens(TokenMgr *tok_mgr) {
@@ -299,25 +471,18 @@ void TokenMgr_print_tokens(TokenMgr *tok_mgr) {
 	printf("Total Tokens: %lu \n", tok_mgr->tok_ctr);
 	TokenMgr_reset_curr(tok_mgr);
 	for (size_t i = 0; i < tok_mgr->tok_ctr; i++) {
-		printf("--> %s\n", tok_mgr->toks_curr[i]->value);
+		printf("--> %s\n", TokenMgr_token_value(tok_mgr, &tok_mgr->toks[i]));
 	}
 }
 
 int TokenMgr_free(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "Tokenizer free")) return -1;
 	
-	TokenMgr_reset_curr(tok_mgr);
-	
-	for (size_t i = 0; i < tok_mgr->tok_ctr; i++) {
-		free(tok_mgr->toks_curr[i]->value);
-		free(tok_mgr->toks_curr[i]);
-	}
-
-	// Free resources.
-	free(tok_mgr->toks_curr);
+	// Free resources. Source buffer belongs to caller.
+	free(tok_mgr->toks);
+	tok_mgr->toks = NULL;
 	tok_mgr->toks_curr = NULL;
-	tok_mgr->toks_head = NULL;
-	tok_mgr->toks_tail = NULL;
+	tok_mgr->src = NULL;
 	free(tok_mgr);
 	tok_mgr = NULL;
 
@@ -328,46 +493,49 @@ Token *TokenMgr_next_token(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "Tokenizer next token")) return NULL;
 	
 	// Don't surpass final token.
-	if (*tok_mgr->toks_curr == tok_mgr->toks_tail)
+	if (TokenMgr_is_last_token(tok_mgr))
 		return NULL;		
 
-	tok_mgr->toks_curr++;	
-	return *tok_mgr->toks_curr;
+	return ++tok_mgr->toks_curr;
 }
 
 Token *TokenMgr_prev_token(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "Tokenizer prev token")) return NULL;
 
 	// Ensure don't surpass first token.
-	if (*tok_mgr->toks_curr == tok_mgr->toks_head)
-		return *tok_mgr->toks_curr;
+	if (tok_mgr->toks_curr == tok_mgr->toks)
+		return tok_mgr->toks_curr;
 
-	tok_mgr->toks_curr--;
-	Token *prev = *tok_mgr->toks_curr;
-	tok_mgr->toks_curr++;
-	return prev;
+	return tok_mgr->toks_curr - 1;
 }
 
 int TokenMgr_is_last_token(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "Tokenizer last token")) return -1;
-	return *tok_mgr->toks_curr  == tok_mgr->toks_tail;
+	return tok_mgr->toks_curr == tok_mgr->toks + tok_mgr->tok_ctr - 1;
 }
 
 Token *TokenMgr_current_token(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "Tokenizer current token")) return NULL;
-	return *tok_mgr->toks_curr;
+	return tok_mgr->toks_curr;
 }
 
 void TokenMgr_reset_curr(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "Tokenizer reset")) return;
-	while (*tok_mgr->toks_curr != tok_mgr->toks_head) {
-		tok_mgr->toks_curr--;
-	}
+	tok_mgr->toks_curr = tok_mgr->toks;
 }
 
-Token **grow_curr_tokens(TokenMgr *tok_mgr) {
+Token *grow_tokens(TokenMgr *tok_mgr) {
 	if (null_check(tok_mgr, "grow tokens")) return NULL;
+	
+	// Keep position of current token since array may move.
+	size_t curr_idx = tok_mgr->toks_curr - tok_mgr->toks;
+	Token *toks_new = realloc(tok_mgr->toks, sizeof(Token) * tok_mgr->tok_cap * 2);		
+	
+	if (!toks_new)
+		return NULL;
+
 	tok_mgr->tok_cap *= 2;
-	Token **toks_curr_new = realloc(tok_mgr->toks_curr, sizeof(Token *) * tok_mgr->tok_cap);		
-	return toks_curr_new;
+	tok_mgr->toks = toks_new;
+	tok_mgr->toks_curr = toks_new + curr_idx;
+	return toks_new;
 }
@@ -2,22 +2,119 @@
 #include <string.h>
 #include "tokens.h"
 
+#include "kwhash.h"
+
+// Spelling of keywords, indexed by KeywordId.
 static const char *Keywords[] = {
-	"print", "func", "if", "else", "foreach", "assert"
+	[E_KW_NONE] = NULL,
+#define KEYWORD(id, str) [id] = str,
+#include "keywords.def"
+#undef KEYWORD
+};
+
+// Initializers covering every character of a range.
+#define CC_LOWER(v) \
+	['a'] = (v), ['b'] = (v), ['c'] = (v), ['d'] = (v), ['e'] = (v), ['f'] = (v), ['g'] = (v), ['h'] = (v), ['i'] = (v), \
+	['j'] = (v), ['k'] = (v), ['l'] = (v), ['m'] = (v), ['n'] = (v), ['o'] = (v), ['p'] = (v), ['q'] = (v), ['r'] = (v), \
+	['s'] = (v), ['t'] = (v), ['u'] = (v), ['v'] = (v), ['w'] = (v), ['x'] = (v), ['y'] = (v), ['z'] = (v)
+#define CC_UPPER(v) \
+	['A'] = (v), ['B'] = (v), ['C'] = (v), ['D'] = (v), ['E'] = (v), ['F'] = (v), ['G'] = (v), ['H'] = (v), ['I'] = (v), \
+	['J'] = (v), ['K'] = (v), ['L'] = (v), ['M'] = (v), ['N'] = (v), ['O'] = (v), ['P'] = (v), ['Q'] = (v), ['R'] = (v), \
+	['S'] = (v), ['T'] = (v), ['U'] = (v), ['V'] = (v), ['W'] = (v), ['X'] = (v), ['Y'] = (v), ['Z'] = (v)
+#define CC_DIGITS(v) \
+	['0'] = (v), ['1'] = (v), ['2'] = (v), ['3'] = (v), ['4'] = (v), ['5'] = (v), ['6'] = (v), ['7'] = (v), ['8'] = (v), \
+	['9'] = (v)
+
+const unsigned char Char_class[256] = {
+	['\0'] = E_CC_NUL,
+	[' '] = E_CC_SPACE, ['\t'] = E_CC_SPACE, ['\v'] = E_CC_SPACE, ['\f'] = E_CC_SPACE, ['\r'] = E_CC_SPACE,
+	[NEWLINE] = E_CC_NEWLINE,
+	[COMMENT] = E_CC_COMMENT,
+	CC_LOWER(E_CC_ALPHA), CC_UPPER(E_CC_ALPHA),
+	CC_DIGITS(E_CC_DIGIT),
+	[LBRACKET] = E_CC_SINGLE, [RBRACKET] = E_CC_SINGLE,
+	[LPAREN] = E_CC_SINGLE, [RPAREN] = E_CC_SINGLE,
+	[PLUS] = E_CC_SINGLE, [MINUS] = E_CC_SINGLE,
+	[ASTERISK] = E_CC_SINGLE, [FSLASH] = E_CC_SINGLE,
+	[COMMA] = E_CC_SINGLE,
+	[LBRACE] = E_CC_LBRACE,
+	[RBRACE] = E_CC_RBRACE,
+	[BTICK] = E_CC_BTICK,
+	[DQUOTE] = E_CC_DQUOTE,
+	[VAR] = E_CC_VAR,
+	[BANG] = E_CC_BANG,
+	[LESSTHAN] = E_CC_LESSTHAN,
+	[GREATERTHAN] = E_CC_GREATERTHAN,
+	[EQUAL] = E_CC_EQUAL
+};
+
+const unsigned char Char_flags[256] = {
+	[' '] = CF_SPACE, ['\t'] = CF_SPACE, ['\v'] = CF_SPACE, ['\f'] = CF_SPACE, ['\r'] = CF_SPACE,
+	CC_LOWER(CF_ALPHA | CF_IDENT), CC_UPPER(CF_ALPHA | CF_IDENT),
+	CC_DIGITS(CF_DIGIT | CF_IDENT),
+	['_'] = CF_IDENT, [MINUS] = CF_IDENT
+};
+
+const unsigned char Char_token[256] = {
+	[LBRACKET] = E_LBRACKET_TOKEN, [RBRACKET] = E_RBRACKET_TOKEN,
+	[LPAREN] = E_LPAREN_TOKEN, [RPAREN] = E_RPAREN_TOKEN,
+	[PLUS] = E_PLUS_TOKEN, [MINUS] = E_MINUS_TOKEN,
+	[ASTERISK] = E_ASTERISK_TOKEN, [FSLASH] = E_FSLASH_TOKEN,
+	[COMMA] = E_COMMA_TOKEN
+};
+
+// Fixed values of literal tokens, indexed by TokenType. NULL entries are read from source.
+static char *Literals[] = {
+	[E_EOF_TOKEN] = "TAIL",
+	[E_EEQUAL_TOKEN] = "==",
+	[E_EQUAL_TOKEN] = "=",
+	[E_LBRACE_TOKEN] = "{",
+	[E_RBRACE_TOKEN] = "}",
+	[E_VAR_TOKEN] = "$",
+	[E_PLUS_TOKEN] = "+",
+	[E_MINUS_TOKEN] = "-",
+	[E_ASTERISK_TOKEN] = "*",
+	[E_FSLASH_TOKEN] = "/",
+	[E_LPAREN_TOKEN] = "(",
+	[E_RPAREN_TOKEN] = ")",
+	[E_LESSTHAN_TOKEN] = "<",
+	[E_LESSTHANEQ_TOKEN] = "<=",
+	[E_GREATERTHAN_TOKEN] = ">",
+	[E_GREATERTHANEQ_TOKEN] = ">=",
+	[E_BETWEEN_TOKEN] = "><",
+	[E_NOT_TOKEN] = "!",
+	[E_NEQUAL_TOKEN] = "!=",
+	[E_COMMA_TOKEN] = ",",
+	[E_LBRACKET_TOKEN] = "[",
+	[E_RBRACKET_TOKEN] = "]"
 };
 
+char *token_literal(TokenType type) {
+	if ((size_t) type >= sizeof(Literals) / sizeof(Literals[0]))
+		return NULL;
+	return Literals[type];
+}
+
+KeywordId keyword_lookup(const char *str, size_t len) {
+	if (!str)
+		return E_KW_NONE;
+
+	KeywordId id = Kw_slots[kw_hash(KW_HASH_SEED, str, len) % KW_HASH_SIZE];
+	const char *kw = Keywords[id];
+
+	if (strncmp(kw, str, len) != 0 || kw[len] != '\0')
+		return E_KW_NONE;
+	return id;
+}
+
+const char *keyword_name(KeywordId id) {
+	if ((size_t) id >= E_KW_COUNT)
+		return NULL;
+	return Keywords[id];
+}
+
 int is_valid_keyword(char *str) {
-	int ret = 0;
-	
 	if (!str)
-		return ret;
-	
-	for (int x = 0; x < KWORDS_SIZE; x++) {
-		const char *t = Keywords[x];
-		if (strcmp(t, str) == 0) {
-			ret = 1;
-			break;
-		}
-	}
-	return ret;
+		return 0;
+	return keyword_lookup(str, strlen(str)) != E_KW_NONE;
 }
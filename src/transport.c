@@ -0,0 +1,54 @@
+#include <stdlib.h>
+#include "transport.h"
+#include "utils.h"
+
+TransportSession *Transport_open(Transport *transport, const char *host) {
+	if (null_check(transport, "transport open") || null_check((void *) host, "transport open")) return NULL;
+
+	TransportSession *session = calloc(1, sizeof(TransportSession));
+	if (null_check(session, "transport open"))
+		return NULL;
+
+	session->transport = transport;
+	session->host = string_dup((char *) host);
+
+	if (!session->host || (transport->open && transport->open(session) == -1)) {
+		free(session->host);
+		free(session);
+		return NULL;
+	}
+
+	return session;
+}
+
+int Transport_run(TransportSession *session, const char *cmd, TransportResult *res) {
+	if (null_check(session, "transport run") || null_check(res, "transport run")) return -1;
+
+	res->status = -1;
+	if (!cmd)
+		return -1;
+
+	return session->transport->run(session, cmd, res);
+}
+
+void Transport_close(TransportSession *session) {
+	if (!session) return;
+
+	if (session->transport->close)
+		session->transport->close(session);
+	free(session->host);
+	free(session);
+}
+
+TransportResult TransportResult_new(void) {
+	TransportResult res = { VRope_new(), VRope_new(), -1 };
+	return res;
+}
+
+void TransportResult_free(TransportResult *res) {
+	if (!res) return;
+
+	VRope_free(&res->out);
+	VRope_free(&res->err);
+	res->status = -1;
+}
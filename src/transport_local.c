@@ -0,0 +1,516 @@
+// pipe2() is needed to create pipes close on exec atomically.
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "transport.h"
+#include "vstring.h"
+
+// First char of a marker, which appears nowhere else in it.
+#define MARK_START '\036'
+
+#define HOST_VAR "VMEL_HOST="
+
+extern char **environ;
+
+/**
+ * Output stream of a command being read.
+ *
+ * A session stream ends at the marker the shell prints after the command rather than
+ * at end of file. mark is followed by the exit status and '\n' on stdout and by '\n'
+ * alone on stderr, mark_at being where the marker started inside rope. eof is set
+ * once the stream closed.
+ */
+typedef struct {
+	int fd;
+	VRope *rope;
+	const char *mark;
+	size_t mark_len;
+	size_t matched;
+	size_t mark_at;
+	int in_status;
+	int status;
+	int done;
+	int eof;
+} LocalStream;
+
+// Long lived shell of a session, pid -1 while not running.
+typedef struct {
+	char **env;
+	pid_t pid;
+	int in;
+	int out;
+	int err;
+	char mark[64];
+	size_t mark_len;
+} LocalShell;
+
+// Create a pipe whose ends aren't inherited by other children, the spawned
+// child gets its own copy through dup2. Sessions may be opened from several
+// threads at once so the flag has to be set as the pipe is created.
+static int local_pipe(int fds[2]) {
+	return pipe2(fds, O_CLOEXEC);
+}
+
+// Environment of the commands run for a host, ours with HOST_VAR set to host.
+static char **local_env(const char *host) {
+	size_t env_ctr = 0;
+	size_t len = strlen(host);
+
+	while (environ[env_ctr])
+		env_ctr++;
+
+	char **env = malloc((env_ctr + 2) * sizeof(char *));
+	char *var = malloc(sizeof(HOST_VAR) + len);
+
+	if (!env || !var) {
+		free(env);
+		free(var);
+		return NULL;
+	}
+
+	memcpy(var, HOST_VAR, sizeof(HOST_VAR) - 1);
+	memcpy(var + sizeof(HOST_VAR) - 1, host, len + 1);
+	env[0] = var;
+	env_ctr = 1;
+
+	for (char **it = environ; *it; it++)
+		if (strncmp(*it, HOST_VAR, sizeof(HOST_VAR) - 1) != 0)
+			env[env_ctr++] = *it;
+
+	env[env_ctr] = NULL;
+	return env;
+}
+
+// Free an environment made by local_env(), only its first entry is owned.
+static void local_env_free(char **env) {
+	if (!env)
+		return;
+
+	free(env[0]);
+	free(env);
+}
+
+// Close a descriptor unless it was never opened.
+static void local_close(int fd) {
+	if (fd != -1)
+		close(fd);
+}
+
+// Look for the marker in n bytes just read into the rope, starting at rope offset pos.
+static void local_scan(LocalStream *stream, const char *data, size_t n, size_t pos) {
+	for (size_t i = 0; i < n && !stream->done; i++) {
+		char c = data[i];
+
+		if (stream->in_status) {
+			if (c >= '0' && c <= '9')
+				stream->status = stream->status * 10 + (c - '0');
+			else if (c == '\n')
+				stream->done = 1;
+			continue;
+		}
+
+		// Skip ahead to the next possible start of the marker.
+		if (!stream->matched) {
+			const char *start = memchr(data + i, MARK_START, n - i);
+			if (!start)
+				return;
+			i = start - data;
+			c = *start;
+		}
+
+		if (c == stream->mark[stream->matched]) {
+			if (!stream->matched)
+				stream->mark_at = pos + i;
+			if (++stream->matched == stream->mark_len)
+				stream->in_status = 1;
+		}
+		else if (c == MARK_START) {
+			stream->mark_at = pos + i;
+			stream->matched = 1;
+		}
+		else {
+			stream->matched = 0;
+		}
+	}
+}
+
+// Read whatever is available from a stream straight into its rope.
+// Return 0 once at end of file, 1 if more may follow.
+static int local_drain(LocalStream *stream) {
+	size_t avail;
+	size_t pos = stream->rope->size;
+	char *buff = VRope_spare(stream->rope, 1, &avail);
+
+	if (!buff)
+		return 0;
+
+	ssize_t n = read(stream->fd, buff, avail);
+	if (n > 0) {
+		VRope_commit(stream->rope, n);
+		if (stream->mark)
+			local_scan(stream, buff, n, pos);
+		return 1;
+	}
+
+	return n == -1 && errno == EINTR;
+}
+
+// Milliseconds on the monotonic clock.
+static long long local_now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+// Read stdout and stderr as they arrive so neither pipe fills up, until both
+// saw their marker or end of file, for at most timeout_ms unless 0.
+// Return 0 if successful, 1 if the timeout passed first otherwise -1.
+static int local_read(LocalStream streams[2], unsigned int timeout_ms) {
+	struct pollfd fds[2];
+	int open_ctr = 0;
+	long long deadline = timeout_ms ? local_now_ms() + timeout_ms : 0;
+
+	for (int i = 0; i < 2; i++) {
+		fds[i].fd = streams[i].fd;
+		fds[i].events = POLLIN;
+		open_ctr++;
+	}
+
+	while (open_ctr) {
+		long long left = deadline ? deadline - local_now_ms() : -1;
+		if (deadline && left <= 0)
+			return 1;
+
+		if (poll(fds, 2, deadline ? (int) left : -1) == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		for (int i = 0; i < 2; i++) {
+			if (fds[i].fd == -1 || !fds[i].revents)
+				continue;
+
+			streams[i].eof = !local_drain(&streams[i]);
+			if (streams[i].eof || streams[i].done) {
+				// Polling a negative descriptor is a no op.
+				fds[i].fd = -1;
+				open_ctr--;
+			}
+		}
+	}
+
+	return 0;
+}
+
+// Spawn argv with stdout and stderr connected to out and err, stdin to in or /dev/null if -1.
+// With pgroup set the child leads a process group of its own.
+static pid_t local_spawn(char **argv, char **env, int in, int out, int err, int pgroup) {
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_t attr;
+	pid_t pid = -1;
+	int ok = 0;
+
+	if (posix_spawn_file_actions_init(&actions) != 0)
+		return -1;
+	if (posix_spawnattr_init(&attr) != 0) {
+		posix_spawn_file_actions_destroy(&actions);
+		return -1;
+	}
+
+	if (pgroup && (posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP) != 0
+		|| posix_spawnattr_setpgroup(&attr, 0) != 0))
+		goto done;
+
+	if (in == -1)
+		ok = posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0) == 0;
+	else
+		ok = posix_spawn_file_actions_adddup2(&actions, in, 0) == 0;
+
+	if (ok && posix_spawn_file_actions_adddup2(&actions, out, 1) == 0
+		&& posix_spawn_file_actions_adddup2(&actions, err, 2) == 0
+		&& posix_spawn(&pid, "/bin/sh", &actions, &attr, argv, env) != 0)
+		pid = -1;
+
+done:
+	posix_spawnattr_destroy(&attr);
+	posix_spawn_file_actions_destroy(&actions);
+	return pid;
+}
+
+// Wait for a child and convert its wait status to the exit code a shell would report.
+static int local_wait(pid_t pid) {
+	int status = 0;
+
+	while (waitpid(pid, &status, 0) == -1)
+		if (errno != EINTR)
+			return -1;
+
+	if (WIFEXITED(status))
+		return WEXITSTATUS(status);
+	if (WIFSIGNALED(status))
+		return 128 + WTERMSIG(status);
+	return -1;
+}
+
+// Run a command in a fresh /bin/sh -c.
+static int local_run(TransportSession *session, const char *cmd, TransportResult *res) {
+	char *argv[] = { "sh", "-c", (char *) cmd, NULL };
+	int out[2] = { -1, -1 };
+	int err[2] = { -1, -1 };
+	pid_t pid = -1;
+
+	if (local_pipe(out) == 0 && local_pipe(err) == 0)
+		pid = local_spawn(argv, session->ctx, -1, out[1], err[1], session->timeout_ms != 0);
+
+	// Write ends belong to the child now, reads see end of file once it exits.
+	local_close(out[1]);
+	local_close(err[1]);
+
+	if (pid == -1) {
+		local_close(out[0]);
+		local_close(err[0]);
+		return -1;
+	}
+
+	LocalStream streams[2] = {
+		{ .fd = out[0], .rope = &res->out },
+		{ .fd = err[0], .rope = &res->err }
+	};
+	int timed_out = local_read(streams, session->timeout_ms) == 1;
+
+	// The command leads its own process group when there is a timeout.
+	if (timed_out)
+		kill(-pid, SIGKILL);
+	local_close(out[0]);
+	local_close(err[0]);
+
+	res->status = local_wait(pid);
+	if (timed_out && res->status != -1)
+		res->status = TRANSPORT_TIMEOUT_STATUS;
+	return res->status == -1 ? -1 : 0;
+}
+
+// Spawn a command in a fresh /bin/sh -c without waiting for it. Only our read ends
+// are non blocking, the child's write ends share nothing with them. The child leads
+// its own process group so killing it on a timeout takes what it started along.
+static int local_start(TransportSession *session, const char *cmd, TransportProc *proc) {
+	char *argv[] = { "sh", "-c", (char *) cmd, NULL };
+	int out[2] = { -1, -1 };
+	int err[2] = { -1, -1 };
+	pid_t pid = -1;
+
+	if (local_pipe(out) == 0 && local_pipe(err) == 0
+		&& fcntl(out[0], F_SETFL, O_NONBLOCK) == 0 && fcntl(err[0], F_SETFL, O_NONBLOCK) == 0)
+		pid = local_spawn(argv, session->ctx, -1, out[1], err[1], 1);
+
+	local_close(out[1]);
+	local_close(err[1]);
+
+	if (pid == -1) {
+		local_close(out[0]);
+		local_close(err[0]);
+		return -1;
+	}
+
+	proc->pid = pid;
+	proc->out = out[0];
+	proc->err = err[0];
+	return 0;
+}
+
+// Stop the shell of a session, it exits once its stdin is closed.
+static void local_shell_stop(LocalShell *shell) {
+	local_close(shell->in);
+	local_close(shell->out);
+	local_close(shell->err);
+	shell->in = shell->out = shell->err = -1;
+
+	if (shell->pid != -1)
+		local_wait(shell->pid);
+	shell->pid = -1;
+}
+
+// Start the shell of a session reading commands from a pipe. The shell leads its own
+// process group so a command past its timeout can be killed along with the shell.
+static int local_shell_start(LocalShell *shell) {
+	char *argv[] = { "sh", "-s", NULL };
+	int in[2] = { -1, -1 };
+	int out[2] = { -1, -1 };
+	int err[2] = { -1, -1 };
+
+	if (local_pipe(in) == 0 && local_pipe(out) == 0 && local_pipe(err) == 0)
+		shell->pid = local_spawn(argv, shell->env, in[0], out[1], err[1], 1);
+
+	local_close(in[0]);
+	local_close(out[1]);
+	local_close(err[1]);
+	shell->in = in[1];
+	shell->out = out[0];
+	shell->err = err[0];
+
+	if (shell->pid == -1) {
+		local_shell_stop(shell);
+		return -1;
+	}
+
+	return 0;
+}
+
+// Write all of a buffer, the shell may take it in several reads.
+static int local_write(int fd, const char *buff, size_t len) {
+	while (len) {
+		ssize_t n = write(fd, buff, len);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+		buff += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+// Build the script running cmd in the shell of a session. The command goes through eval
+// quoted, so a syntax error can't swallow the markers, and reads /dev/null rather than
+// the commands which follow it.
+static int local_shell_script(LocalShell *shell, const char *cmd, VString *script) {
+	const char *quote;
+	int ok = VString_pushs(script, "eval '") != NULL;
+
+	while (ok && (quote = strchr(cmd, '\''))) {
+		ok = VString_pushn(script, cmd, quote - cmd) && VString_pushs(script, "'\\''");
+		cmd = quote + 1;
+	}
+
+	// The marker ends with ':' which printf leaves alone, the rest is letters, digits and '-'.
+	return ok && VString_pushs(script, (char *) cmd)
+		&& VString_pushf(script, "' </dev/null\n"
+			"printf '\\036%s%%d\\n' $?\n"
+			"printf '\\036%s\\n' >&2\n", shell->mark + 1, shell->mark + 1) ? 0 : -1;
+}
+
+// Start the shell of a new session.
+static int local_shell_open(TransportSession *session) {
+	static unsigned long session_ctr = 0;
+	LocalShell *shell = malloc(sizeof(LocalShell));
+	struct timespec ts;
+
+	if (!shell)
+		return -1;
+
+	// A shell which died mid write would otherwise kill us.
+	signal(SIGPIPE, SIG_IGN);
+
+	// Unique enough that no command prints it by chance.
+	clock_gettime(CLOCK_REALTIME, &ts);
+	shell->mark_len = snprintf(shell->mark, sizeof(shell->mark), "%cvmel-%ld-%lu-%lx:", MARK_START,
+		(long) getpid(), __atomic_fetch_add(&session_ctr, 1, __ATOMIC_RELAXED), (unsigned long) ts.tv_nsec);
+	shell->pid = -1;
+	shell->in = shell->out = shell->err = -1;
+	shell->env = local_env(session->host);
+
+	if (!shell->env || local_shell_start(shell) == -1) {
+		local_env_free(shell->env);
+		free(shell);
+		return -1;
+	}
+
+	session->ctx = shell;
+	return 0;
+}
+
+// Run a command in the shell of a session, starting a new shell if the last one exited.
+static int local_shell_run(TransportSession *session, const char *cmd, TransportResult *res) {
+	LocalShell *shell = session->ctx;
+	VString script = VString_new();
+
+	if (shell->pid == -1 && local_shell_start(shell) == -1)
+		return -1;
+
+	if (local_shell_script(shell, cmd, &script) == -1
+		|| local_write(shell->in, VString_str(&script), script.str_size) == -1) {
+		VString_free(&script);
+		local_shell_stop(shell);
+		return -1;
+	}
+	VString_free(&script);
+
+	LocalStream streams[2] = {
+		{ .fd = shell->out, .rope = &res->out, .mark = shell->mark, .mark_len = shell->mark_len },
+		{ .fd = shell->err, .rope = &res->err, .mark = shell->mark, .mark_len = shell->mark_len }
+	};
+	int got = local_read(streams, session->timeout_ms);
+	if (got == 0 && streams[0].done && streams[1].done) {
+		VRope_truncate(&res->out, streams[0].mark_at);
+		VRope_truncate(&res->err, streams[1].mark_at);
+		res->status = streams[0].status;
+		return 0;
+	}
+
+	// Timed out, the shell goes along with the command and the next command starts a new one.
+	if (got == 1) {
+		kill(-shell->pid, SIGKILL);
+		local_shell_stop(shell);
+		res->status = TRANSPORT_TIMEOUT_STATUS;
+		return 0;
+	}
+
+	// Shell exited, i.e the command called exit, its status being the command's.
+	local_close(shell->in);
+	shell->in = -1;
+	res->status = local_wait(shell->pid);
+	shell->pid = -1;
+	local_shell_stop(shell);
+	return res->status == -1 ? -1 : 0;
+}
+
+// Stop the shell of a session.
+static void local_shell_close(TransportSession *session) {
+	LocalShell *shell = session->ctx;
+
+	if (!shell)
+		return;
+
+	local_shell_stop(shell);
+	local_env_free(shell->env);
+	free(shell);
+	session->ctx = NULL;
+}
+
+// Commands of a session share its environment.
+static int local_open(TransportSession *session) {
+	session->ctx = local_env(session->host);
+	return session->ctx ? 0 : -1;
+}
+
+// Free the environment of a session.
+static void local_close_session(TransportSession *session) {
+	local_env_free(session->ctx);
+	session->ctx = NULL;
+}
+
+// Every command runs in its own process, a session only holds the environment.
+static Transport Local = { "local", local_open, local_run, local_close_session, local_start };
+
+// Markers are only parsed when running, so sessions can't be started asynchronously.
+static Transport Local_session = { "local-session", local_shell_open, local_shell_run, local_shell_close, NULL };
+
+Transport *Transport_local(void) {
+	return &Local;
+}
+
+Transport *Transport_local_session(void) {
+	return &Local_session;
+}
@@ -1,38 +1,127 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "utils.h"
+#include "tokens.h"
 
 void print_usage(void) {
-	printf("Usage: vmel [script]\n");
+	printf("Usage: vmel [--no-cache] [--lex-threads N] [--tree-walk] [--session] [--inventory FILE] [--forks N] [--timeout SECS] [--pool-stats] [--dump-ast] [script | -]\n");
 }
 
-char *file_to_buffer(const char *filename) {
-	// File pointer.
-	FILE *fptr = fopen(filename, "r");
-	// Output buffer.
-	char *buff = NULL;
-	// File size;
-	long f_size = 0;
+// Read an entire stream into a null terminated heap buffer.
+static SrcFile *src_read_stream(int fd) {
+	SrcFile *src = malloc(sizeof(SrcFile));
+	size_t cap = 4096;
+	ssize_t rd = 0;
 
-	if (fptr == NULL) {
-		perror("Error: ");
-		exit(-1);
+	if (null_check(src, "srcfile read"))
+		return NULL;
+
+	src->buff = malloc(cap);
+	src->len = 0;
+	src->map_len = 0;
+
+	if (null_check(src->buff, "srcfile read")) {
+		SrcFile_close(src);
+		return NULL;
 	}
 
-	fseek(fptr, 0, SEEK_END);
-	
-	f_size = ftell(fptr);
-	
-	fseek(fptr, 0, SEEK_SET);
-	
-	if (f_size > 0) {
-		buff = calloc(1, f_size+1);	
-		fread(buff, f_size, 1, fptr);
+	while ((rd = read(fd, src->buff + src->len, cap - src->len - 1)) != 0) {
+		if (rd < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("Error: ");
+			SrcFile_close(src);
+			return NULL;
+		}
+		src->len += rd;
+		if (cap - src->len == 1) {
+			char *n_buff = realloc(src->buff, cap * 2);
+
+			// Old buffer is still owned by src and freed along with it.
+			if (null_check(n_buff, "srcfile read")) {
+				SrcFile_close(src);
+				return NULL;
+			}
+			src->buff = n_buff;
+			cap *= 2;
+		}
 	}
-		
-	fclose(fptr);
-	return buff;
+
+	src->buff[src->len] = '\0';
+	return src;
+}
+
+// Map a regular file. Mapping is one byte longer than the file so that it is always null terminated.
+static SrcFile *src_map_file(int fd, size_t len) {
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t map_len = (len + 1 + page - 1) / page * page;
+	SrcFile *src = NULL;
+
+	// Reserve zeroed pages then place the file over the start of them.
+	char *base = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+		return NULL;
+
+	if (mmap(base, len, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		munmap(base, map_len);
+		return NULL;
+	}
+
+	madvise(base, map_len, MADV_SEQUENTIAL);
+
+	src = malloc(sizeof(SrcFile));
+	if (null_check(src, "srcfile map")) {
+		munmap(base, map_len);
+		return NULL;
+	}
+
+	src->buff = base;
+	src->len = len;
+	src->map_len = map_len;
+	return src;
+}
+
+SrcFile *SrcFile_open(const char *filename) {
+	if (null_check((void *) filename, "srcfile open")) return NULL;
+
+	int fd = STDIN_FILENO;
+	struct stat st;
+	SrcFile *src = NULL;
+
+	if (strcmp(filename, "-") != 0 && (fd = open(filename, O_RDONLY)) < 0) {
+		perror("Error: ");
+		return NULL;
+	}
+
+	// Only regular non empty files can be mapped, everything else is read.
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+		src = src_map_file(fd, st.st_size);
+
+	if (!src)
+		src = src_read_stream(fd);
+
+	if (fd != STDIN_FILENO)
+		close(fd);
+
+	return src;
+}
+
+void SrcFile_close(SrcFile *src) {
+	if (!src)
+		return;
+
+	if (src->map_len)
+		munmap(src->buff, src->map_len);
+	else
+		free(src->buff);
+
+	free(src);
 }
 
 int string_to_int(char *str, size_t len) {
@@ -52,6 +141,19 @@ int string_to_int(char *str, size_t len) {
 
 }
 
+long long string_to_int64(const char *str, size_t len) {
+	if (str == NULL)
+		return -1;
+
+	unsigned long long dec = 0;
+	for (size_t i = 0; i < len; i++) {
+		if (!isdigit((unsigned char) str[i]))
+			return -1;
+		dec = dec * 10 + (str[i] - '0');
+	}
+	return (long long) dec;
+}
+
 char *string_map_vars(const char *src, char **vars, size_t src_len, size_t vars_len) {
 	if (src == NULL || vars == NULL)
 		return NULL;
@@ -160,6 +262,34 @@ unsigned int string_to_ascii(char *str_rep) {
 	return asci;
 }
 
+unsigned int string_hash(const char *str, size_t len) {
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ (unsigned char) str[i]) * 16777619u;
+	}
+	return hash;
+}
+
+unsigned long long buffer_hash64(const void *buff, size_t len) {
+	const unsigned char *bytes = buff;
+	unsigned long long hash = 0xcbf29ce484222325ull ^ len;
+	unsigned long long word = 0;
+	size_t i = 0;
+
+	for (; i + 8 <= len; i += 8) {
+		memcpy(&word, bytes + i, 8);
+		hash = (hash ^ word) * 0x100000001b3ull;
+		hash ^= hash >> 29;
+	}
+
+	// Remaining tail bytes.
+	word = 0;
+	memcpy(&word, bytes + i, len - i);
+	hash = (hash ^ word) * 0x100000001b3ull;
+	hash ^= hash >> 32;
+	return hash;
+}
+
 int is_valid_identifier(char id) {
-	return (isalpha(id) || id == '_' || id == '-' || isdigit(id));
+	return char_is(id, CF_IDENT);
 }
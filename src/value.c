@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "value.h"
+#include "utils.h"
+
+// Append the string form of a value, strings inside arrays are quoted.
+static void value_format(const Value *val, VString *buff, int quote) {
+	switch (val->type) {
+		case E_INT_VALUE:
+		case E_BOOL_VALUE:
+			if (val->text)
+				VString_pushs(buff, val->text);
+			else
+				VString_pushf(buff, "%lld", val->as.num);
+			break;
+		case E_STR_VALUE:
+			if (quote)
+				VString_pushc(buff, '"');
+			VString_pushs(buff, val->as.str);
+			if (quote)
+				VString_pushc(buff, '"');
+			break;
+		case E_ARRAY_VALUE:
+			VString_pushc(buff, '[');
+			for (size_t i = 0; i < val->as.arr->len; i++) {
+				if (i)
+					VString_pushs(buff, ", ");
+				value_format(&val->as.arr->items[i], buff, 1);
+			}
+			VString_pushc(buff, ']');
+			break;
+		default:
+			break;
+	}
+}
+
+Value Value_array(size_t len) {
+	ValueArray *arr = malloc(sizeof(ValueArray) + len * sizeof(Value));
+
+	if (null_check(arr, "value array"))
+		return Value_none();
+
+	arr->len = len;
+	for (size_t i = 0; i < len; i++)
+		arr->items[i] = Value_none();
+
+	return (Value) { E_ARRAY_VALUE, 1, { .arr = arr }, NULL };
+}
+
+Value Value_copy(const Value *val) {
+	Value copy = *val;
+
+	if (val->type == E_STR_VALUE && val->owned) {
+		copy.as.str = string_dup(val->as.str);
+	}
+	else if (val->type == E_ARRAY_VALUE) {
+		copy = Value_array(val->as.arr->len);
+		for (size_t i = 0; copy.type == E_ARRAY_VALUE && i < val->as.arr->len; i++)
+			copy.as.arr->items[i] = Value_copy(&val->as.arr->items[i]);
+	}
+
+	return copy;
+}
+
+void Value_free(Value *val) {
+	if (!val) return;
+
+	if (val->type == E_STR_VALUE && val->owned) {
+		free(val->as.str);
+	}
+	else if (val->type == E_ARRAY_VALUE) {
+		for (size_t i = 0; i < val->as.arr->len; i++)
+			Value_free(&val->as.arr->items[i]);
+		free(val->as.arr);
+	}
+
+	*val = Value_none();
+}
+
+long long Value_to_int(const Value *val) {
+	long long ret = 0;
+
+	switch (val->type) {
+		case E_INT_VALUE:
+		case E_BOOL_VALUE:
+			return val->as.num;
+		case E_STR_VALUE:
+			ret = string_to_int64(val->as.str, strlen(val->as.str));
+			return ret < 0 ? (long long) string_to_ascii(val->as.str) : ret;
+		default:
+			return 0;
+	}
+}
+
+char *Value_to_string(const Value *val, VString *buff) {
+	if (val->type == E_STR_VALUE)
+		return val->as.str;
+
+	VString_clear(buff);
+	value_format(val, buff, 0);
+	return VString_str(buff);
+}
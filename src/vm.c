@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vm.h"
+#include "utils.h"
+
+// Labels as values are a GNU extension, fall back to a switch elsewhere.
+#if defined(__GNUC__) && !defined(VM_NO_COMPUTED_GOTO)
+	#define VM_COMPUTED_GOTO
+#endif
+
+#ifdef VM_COMPUTED_GOTO
+	#define VM_LABEL(op) &&L_##op,
+	#define VM_TARGET(op) L_##op:
+	#define VM_DISPATCH() goto *targets[(in = ip++)->op]
+#else
+	#define VM_TARGET(op) case op:
+	#define VM_DISPATCH() continue
+#endif
+
+// Symbol in slot, NULL for variables which were never declared.
+#define VM_SLOT(slot) ((slot) < sym_ctr ? symbols[slot] : NULL)
+
+// Pop rhs then lhs and push lhs op rhs.
+#define VM_BINARY(expr) do { long long rhs = *--sp; long long lhs = sp[-1]; sp[-1] = (expr); } while (0)
+
+// Defined value of a variable, NULL if never declared or assigned.
+#define VM_VALUE(slot) ((sy = VM_SLOT(slot)) && sy->val.type != E_NONE_VALUE ? &sy->val : NULL)
+
+// Report an undefined variable.
+static void vm_undefined(NexecMgr *nexec_mgr, char *name) {
+	NexecMgr_add_error(nexec_mgr->err_handle, name, FlatAst_value(nexec_mgr->ast, nexec_mgr->curr));
+}
+
+int Vm_run(NexecMgr *nexec_mgr, Bytecode *code) {
+	if (null_check(nexec_mgr, "vm run") || null_check(code, "vm run") || code->ast != nexec_mgr->ast)
+		return -1;
+
+	long long *stack = malloc((code->stack_max + 1) * sizeof(long long));
+	if (null_check(stack, "vm run"))
+		return -1;
+
+	char **strs = code->ast->strs;
+	SyTable *sy_table = nexec_mgr->sy_table;
+	Symbol **symbols = sy_table->symbols;
+	size_t sym_ctr = sy_table->sym_ctr;
+	const Instr *ip = code->code;
+	const Instr *in = NULL;
+	long long *sp = stack;
+	Symbol *sy;
+	Value *val;
+
+#ifdef VM_COMPUTED_GOTO
+	static void *const targets[] = { BC_OPCODES(VM_LABEL) };
+	VM_DISPATCH();
+#else
+	for (;;) switch ((in = ip++)->op) {
+#endif
+
+	VM_TARGET(BC_HALT)
+		goto done;
+
+	VM_TARGET(BC_STMT)
+		nexec_mgr->curr = in->a;
+		VM_DISPATCH();
+
+	VM_TARGET(BC_END_STMT)
+		Error_print_all(nexec_mgr->err_handle);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_PUSH_INT)
+		*sp++ = (long long) ((unsigned long long) in->a | (unsigned long long) in->b << 32);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_PUSH_VAR)
+		if ((val = VM_VALUE(in->a))) {
+			*sp++ = Value_to_int(val);
+		}
+		else {
+			vm_undefined(nexec_mgr, strs[in->b]);
+			*sp++ = 0;
+		}
+		VM_DISPATCH();
+
+	VM_TARGET(BC_PUSH_MIXSTR)
+		*sp++ = (long long) string_to_ascii(Nexec_mixed_string(nexec_mgr, in->a));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_ADD)
+		VM_BINARY(VALUE_WRAP(lhs, +, rhs));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_SUB)
+		VM_BINARY(VALUE_WRAP(lhs, -, rhs));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_MUL)
+		VM_BINARY(VALUE_WRAP(lhs, *, rhs));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_DIV)
+		VM_BINARY(Value_div(lhs, rhs));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_EQ)
+		VM_BINARY(lhs == rhs);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_NE)
+		VM_BINARY(lhs != rhs);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_LT)
+		VM_BINARY(lhs < rhs);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_LE)
+		VM_BINARY(lhs <= rhs);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_GT)
+		VM_BINARY(lhs > rhs);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_GE)
+		VM_BINARY(lhs >= rhs);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_PRINT_INT)
+		printf("%lld\n", *--sp);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_PRINT_STR)
+		printf("%s\n", strs[in->a]);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_PRINT_VAR)
+		if ((val = VM_VALUE(in->a)))
+			printf("%s\n", Value_to_string(val, &nexec_mgr->buff));
+		else
+			vm_undefined(nexec_mgr, strs[in->b]);
+		VM_DISPATCH();
+
+	VM_TARGET(BC_PRINT_MIXSTR)
+		printf("%s\n", Nexec_mixed_string(nexec_mgr, in->a));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_STORE_INT)
+		SyTable_update_slot(sy_table, in->a, Value_int(*--sp));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_STORE_LIT)
+		SyTable_update_slot(sy_table, in->a, Value_int_literal(*--sp, strs[in->b]));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_STORE_BOOL)
+		SyTable_update_slot(sy_table, in->a, Value_bool(*--sp));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_STORE_STR)
+		SyTable_update_slot(sy_table, in->a, Value_str(strs[in->b], 0));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_STORE_VAR)
+		// Unset variables are skipped silently as Nexec_exec() does.
+		if ((val = VM_VALUE(in->b)))
+			SyTable_update_slot(sy_table, in->a, Value_copy(val));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_STORE_MIXSTR)
+		SyTable_update_slot(sy_table, in->a, Value_str(string_dup(Nexec_mixed_string(nexec_mgr, in->b)), 1));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_STORE_ARRAY)
+		SyTable_update_slot(sy_table, in->a, Nexec_array(nexec_mgr, in->b));
+		VM_DISPATCH();
+
+	VM_TARGET(BC_GROUP)
+		Nexec_group_node(nexec_mgr);
+		VM_DISPATCH();
+
+#ifndef VM_COMPUTED_GOTO
+	default:
+		goto done;
+	}
+#endif
+
+done:
+	free(stack);
+	return 0;
+}
@@ -9,79 +9,224 @@
 #include "nexec.h"
 #include "errors.h"
 #include "utils.h"
+#include "vmlc.h"
+#include "vm.h"
+#include "optimize.h"
+#include "executor.h"
 
 int main(int argc, char *argv[]) {
 
 	// Input stream used for file.
 	int err = 0;
-	char *buff_in = NULL;
+	int use_cache = 1;
+	int use_vm = 1;
+	int use_session = 0;
+	int forks = EXECUTOR_DEFAULT_FORKS;
+	double timeout = 0;
+	int pool_stats = 0;
+	const char *inventory_path = NULL;
+	int dump_ast = 0;
+	int lex_threads = -1;
+	int argi = 1;
+	char cache_path[4096];
+	unsigned long long src_hash = 0;
+	SrcFile *src = NULL;
+	Vmlc *vmlc = NULL;
+	InternPool *pool = NULL;
 	TokenMgr *tok_mgr = NULL;
 	NodeMgr *node_mgr = NULL;
+	FlatAst *ast = NULL;
 	SyTable *sy_table = NULL;
 	ParserMgr *par_mgr = NULL;
 	Error *err_handle = NULL;
 	NexecMgr *nexec_mgr = NULL;
+	Inventory *inventory = NULL;
+	Bytecode *code = NULL;
 
-	if (argc < 2) {
+	// Options come before the script.
+	for (; argi < argc && argv[argi][0] == '-' && argv[argi][1] == '-'; argi++) {
+		if (string_compare(argv[argi], "--no-cache")) {
+			use_cache = 0;
+		}
+		else if (string_compare(argv[argi], "--dump-ast")) {
+			// Dumping needs the parsed trees so the cache is bypassed.
+			dump_ast = 1;
+			use_cache = 0;
+		}
+		else if (string_compare(argv[argi], "--tree-walk")) {
+			use_vm = 0;
+		}
+		else if (string_compare(argv[argi], "--session")) {
+			use_session = 1;
+		}
+		else if (string_compare(argv[argi], "--inventory") && argi + 1 < argc) {
+			inventory_path = argv[++argi];
+		}
+		else if (string_compare(argv[argi], "--forks") && argi + 1 < argc) {
+			forks = atoi(argv[++argi]);
+		}
+		else if (string_compare(argv[argi], "--pool-stats")) {
+			pool_stats = 1;
+		}
+		else if (string_compare(argv[argi], "--timeout") && argi + 1 < argc) {
+			timeout = atof(argv[++argi]);
+		}
+		else if (string_compare(argv[argi], "--lex-threads") && argi + 1 < argc) {
+			lex_threads = atoi(argv[++argi]);
+		}
+		else {
+			print_usage();
+			return 1;
+		}
+	}
+
+	if (argi >= argc) {
 		print_usage();
 		return 0;
 	}
 
-	buff_in = file_to_buffer(argv[1]);
+	// Hosts are read up front so a bad inventory fails before anything runs.
+	if (inventory_path) {
+		inventory = Inventory_new();
+		if (!inventory || Inventory_load(inventory, inventory_path) == -1) {
+			Inventory_free(inventory);
+			return 1;
+		}
+	}
+
+	src = SrcFile_open(argv[argi]);
+
+	if (!src) {
+		Inventory_free(inventory);
+		return 1;
+	}
 	
 	// 0 size file.
-	if (!buff_in)
+	if (src->len == 0) {
+		SrcFile_close(src);
+		Inventory_free(inventory);
 		return 0;
+	}
 		
-	tok_mgr = TokenMgr_new();		
-	err = TokenMgr_build_tokens(buff_in, tok_mgr);
-	free(buff_in);
-	
-	if (!err) {
-		
-		// Instantiate required structs.
-		sy_table = SyTable_new();
+	// Strings are interned once and shared by tokens, symbols and nodes.
+	pool = InternPool_new();
+	sy_table = SyTable_new(pool);
+	err_handle = Error_new();
+
+	// An unchanged script is loaded from its cache, skipping tokenizing and parsing.
+	if (use_cache) {
+		src_hash = buffer_hash64(src->buff, src->len);
+		use_cache = !Vmlc_path(cache_path, sizeof(cache_path), src_hash);
+	}
+
+	if (use_cache)
+		vmlc = Vmlc_load(cache_path, src_hash, src->len, pool, sy_table);
+
+	if (vmlc)
+		ast = vmlc->ast;
+
+	if (!vmlc) {
+		tok_mgr = TokenMgr_new(pool);
 		node_mgr = NodeMgr_new();
-		err_handle = Error_new();
 
-		// Initialise Parser with correct structs.
-		par_mgr = ParseMgr_init(tok_mgr, sy_table, node_mgr, err_handle);
+		// Threads are opt in, 0 being one per core.
+		if (lex_threads >= 0)
+			err = TokenMgr_build_tokens_parallel(src->buff, tok_mgr, lex_threads);
+		else
+			err = TokenMgr_build_tokens(src->buff, tok_mgr);
+	
+		if (!err) {
+			// Initialise Parser with correct structs.
+			par_mgr = ParseMgr_init(tok_mgr, sy_table, node_mgr, err_handle);
+
+			Parser_parse(par_mgr);
+
+			// Free since its no longer needed.
+			ParserMgr_free(par_mgr);
+
+			// Lower into the flat encoding executed from, the pointer tree is done with after.
+			if (err_handle->error_ctr == 0) {
+				if (dump_ast)
+					NodeMgr_print_trees(node_mgr, "parsed");
+
+				Optimize_ast(node_mgr, pool);
+
+				if (dump_ast)
+					NodeMgr_print_trees(node_mgr, "optimized");
 
-		Parser_parse(par_mgr);
+				ast = FlatAst_new();
+				err = FlatAst_lower(ast, node_mgr, sy_table);
+			}
+
+			NodeMgr_free(node_mgr);
+			node_mgr = NULL;
+
+			// Cache only scripts which parsed cleanly, before execution assigns values.
+			if (!err && use_cache && ast)
+				Vmlc_save(cache_path, src_hash, src->len, sy_table, ast);
+		}
+	}
 
-		// Free since its no longer needed.
-		ParserMgr_free(par_mgr);
+	// No errors then proceed to execute nodes.
+	if (!err && err_handle->error_ctr == 0) {
+		
+		// Initialise NexecMgr.
+		nexec_mgr = Nexec_init(sy_table, ast, err_handle);
+
+		// Groups run on this machine until there are remote transports.
+		if (nexec_mgr) {
+			nexec_mgr->transport = use_session ? Transport_local_session() : Transport_local();
+			nexec_mgr->inventory = inventory;
+			nexec_mgr->forks = forks > 0 ? forks : 1;
+			nexec_mgr->timeout_ms = timeout > 0 ? (unsigned int) (timeout * 1000) : 0;
+		}
 
-		// No errors then proceed to execute nodes.
-		if (err_handle->error_ctr == 0) {
-			
-			// Initialise NexecMgr.
-			nexec_mgr = Nexec_init(sy_table, node_mgr, err_handle);
+		#ifndef NDEBUG
+			printf("--------------------------------------\n");
+			printf("** Program Output **\n");
+			printf("--------------------------------------\n");
+		#endif
 
-			#ifndef NDEBUG
-				printf("--------------------------------------\n");
-				printf("** Program Output **\n");
-				printf("--------------------------------------\n");
-			#endif
+		// Run compiled, the tree walker remains for --tree-walk.
+		if (use_vm)
+			code = Bytecode_compile(ast);
 
+		if (code) {
+			Vm_run(nexec_mgr, code);
+			Bytecode_free(code);
+		}
+		else {
 			// Iterate through nodes in generated ast and execute.
-			for (size_t i = 0; i < node_mgr->nodes_ctr; i++) {
-				Nexec_exec(nexec_mgr, node_mgr->nodes[i]);
+			for (size_t i = 0; i < ast->root_ctr; i++) {
+				Nexec_exec(nexec_mgr, ast->roots[i]);
 			}
 		}
+
+		// Counters of the workers groups run on, to tune --forks.
+		if (pool_stats && nexec_mgr)
+			TaskPool_print_stats(nexec_mgr->pool, stderr);
 	}
 
 	#ifndef NDEBUG
 		SyTable_print_symbols(sy_table);
-		TokenMgr_print_tokens(tok_mgr);
+		if (tok_mgr)
+			TokenMgr_print_tokens(tok_mgr);
 	#endif
 
 	// Free all resources.
 	NexecMgr_free(nexec_mgr);
 	Error_free(err_handle);
 	SyTable_free(sy_table);
-	NodeMgr_free(node_mgr);
-	TokenMgr_free(tok_mgr);
+	if (node_mgr)
+		NodeMgr_free(node_mgr);
+	if (ast && !vmlc)
+		FlatAst_free(ast);
+	if (tok_mgr)
+		TokenMgr_free(tok_mgr);
+	InternPool_free(pool);
+	Vmlc_free(vmlc);
+	SrcFile_close(src);
+	Inventory_free(inventory);
 
 	return 0;
 }
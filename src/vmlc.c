@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vmlc.h"
+#include "utils.h"
+
+// Number of sections following the header.
+#define VMLC_SECTIONS 10
+
+// Round up to the 8 byte section alignment.
+static size_t vmlc_align(size_t n) {
+	return (n + 7) & ~(size_t) 7;
+}
+
+// Compute section offsets from a header, returns total file size.
+static size_t vmlc_layout(const VmlcHeader *hdr, size_t off[VMLC_SECTIONS]) {
+	size_t sizes[VMLC_SECTIONS] = {
+		(size_t) hdr->str_ctr * sizeof(VmlcString),
+		hdr->node_ctr,
+		hdr->node_ctr,
+		(size_t) hdr->node_ctr * sizeof(unsigned int),
+		(size_t) hdr->node_ctr * sizeof(FlatIdx),
+		(size_t) hdr->node_ctr * sizeof(FlatIdx),
+		(size_t) hdr->kid_ctr * sizeof(FlatIdx),
+		(size_t) hdr->root_ctr * sizeof(FlatIdx),
+		(size_t) hdr->sym_ctr * sizeof(VmlcSymbol),
+		hdr->str_bytes
+	};
+
+	off[0] = vmlc_align(sizeof(VmlcHeader));
+	for (int i = 1; i < VMLC_SECTIONS; i++)
+		off[i] = vmlc_align(off[i - 1] + sizes[i - 1]);
+
+	return off[VMLC_SECTIONS - 1] + hdr->str_bytes;
+}
+
+// Check a string lies inside the string bytes and is null terminated.
+static int vmlc_bad_string(const VmlcHeader *hdr, const char *bytes, VmlcString str) {
+	size_t end = (size_t) str.offset + str.length;
+	return end >= hdr->str_bytes || bytes[end] != '\0';
+}
+
+// Check every operand of a node refers to an earlier node, so trees can't loop,
+// and every slot to a cached symbol.
+static int vmlc_bad_node(const VmlcHeader *hdr, const FlatAst *ast, FlatIdx idx) {
+	enum NodeType type = FlatAst_type(ast, idx);
+	FlatIdx lhs = ast->lhs[idx];
+	FlatIdx rhs = ast->rhs[idx];
+
+	if (type >= E_EOF_NODE || ast->kwids[idx] >= E_KW_COUNT
+		|| (ast->values[idx] != FLAT_NONE && ast->values[idx] >= hdr->str_ctr))
+		return 1;
+
+	switch (type) {
+		case E_IDENTIFIER_NODE:
+			if (rhs != FLAT_NONE && rhs >= hdr->sym_ctr)
+				return 1;
+			return ast->values[idx] == FLAT_NONE;
+		case E_STRING_NODE:
+		case E_MIXSTR_NODE:
+		case E_INTEGER_NODE:
+			return ast->values[idx] == FLAT_NONE;
+		case E_FUNC_NODE:
+			return lhs >= idx;
+		case E_EQUAL_NODE:
+			return lhs >= idx || rhs >= idx || FlatAst_type(ast, lhs) != E_IDENTIFIER_NODE;
+		case E_ARRAY_NODE:
+		case E_GROUP_NODE:
+			if ((size_t) lhs + rhs > hdr->kid_ctr)
+				return 1;
+			for (size_t k = lhs; k < (size_t) lhs + rhs; k++) {
+				if (ast->kids[k] >= idx)
+					return 1;
+				// Groups only hold commands.
+				if (type == E_GROUP_NODE && FlatAst_type(ast, ast->kids[k]) != E_STRING_NODE
+					&& FlatAst_type(ast, ast->kids[k]) != E_MIXSTR_NODE)
+					return 1;
+			}
+			return 0;
+		default:
+			return (FlatAst_is_binop(type) || FlatAst_is_compare(type)) && (lhs >= idx || rhs >= idx);
+	}
+}
+
+// Write a section followed by padding up to the next offset.
+static int vmlc_write(FILE *fp, const void *data, size_t len, size_t pad) {
+	static const char zeros[8] = { 0 };
+
+	if (len && fwrite(data, 1, len, fp) != len)
+		return -1;
+	if (pad && fwrite(zeros, 1, pad, fp) != pad)
+		return -1;
+	return 0;
+}
+
+// Create a directory and any missing parents.
+static int vmlc_mkdirs(char *dir) {
+	for (char *p = dir + 1; *p; p++) {
+		if (*p != '/')
+			continue;
+		*p = '\0';
+		if (mkdir(dir, 0700) && errno != EEXIST) {
+			*p = '/';
+			return -1;
+		}
+		*p = '/';
+	}
+	return (mkdir(dir, 0700) && errno != EEXIST) ? -1 : 0;
+}
+
+int Vmlc_path(char *path, size_t size, unsigned long long src_hash) {
+	const char *dir = getenv("VMEL_CACHE_DIR");
+	const char *sub = "";
+	int len = 0;
+
+	if (!dir || !*dir) {
+		dir = getenv("XDG_CACHE_HOME");
+		sub = "/vmel";
+	}
+
+	if (!dir || !*dir) {
+		dir = getenv("HOME");
+		sub = "/.cache/vmel";
+	}
+
+	if (!dir || !*dir)
+		return -1;
+
+	len = snprintf(path, size, "%s%s/%016llx.vmlc", dir, sub, src_hash);
+	return (len < 0 || (size_t) len >= size) ? -1 : 0;
+}
+
+Vmlc *Vmlc_load(const char *path, unsigned long long src_hash, size_t src_len,
+				InternPool *pool, SyTable *sy_table) {
+	if (!path || null_check(pool, "vmlc load") || null_check(sy_table, "vmlc load")) return NULL;
+
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) || (size_t) st.st_size < sizeof(VmlcHeader)) {
+		close(fd);
+		return NULL;
+	}
+
+	size_t map_len = st.st_size;
+	char *map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED)
+		return NULL;
+
+	const VmlcHeader *hdr = (const VmlcHeader *) map;
+	size_t off[VMLC_SECTIONS];
+
+	if (memcmp(hdr->magic, VMLC_MAGIC, 4) || hdr->version != VMLC_VERSION
+		|| hdr->src_hash != src_hash || hdr->src_len != src_len
+		|| vmlc_layout(hdr, off) != map_len) {
+		munmap(map, map_len);
+		return NULL;
+	}
+
+	const VmlcString *strs = (const VmlcString *) (map + off[0]);
+	const VmlcSymbol *syms = (const VmlcSymbol *) (map + off[8]);
+	const char *bytes = map + off[9];
+	FlatAst *ast = FlatAst_new();
+	int bad = !ast;
+
+	// Node arrays are used straight out of the mapping, they are never written to.
+	if (ast) {
+		ast->borrowed = 1;
+		ast->types = (unsigned char *) (map + off[1]);
+		ast->kwids = (unsigned char *) (map + off[2]);
+		ast->values = (unsigned int *) (map + off[3]);
+		ast->lhs = (FlatIdx *) (map + off[4]);
+		ast->rhs = (FlatIdx *) (map + off[5]);
+		ast->kids = (FlatIdx *) (map + off[6]);
+		ast->roots = (FlatIdx *) (map + off[7]);
+		ast->node_ctr = ast->node_cap = hdr->node_ctr;
+		ast->kid_ctr = ast->kid_cap = hdr->kid_ctr;
+		ast->root_ctr = ast->root_cap = hdr->root_ctr;
+	}
+
+	// Validate everything up front so a bad cache never leaves partial state behind.
+	for (size_t i = 0; !bad && i < hdr->str_ctr; i++)
+		bad = vmlc_bad_string(hdr, bytes, strs[i]);
+
+	for (size_t i = 0; !bad && i < hdr->node_ctr; i++)
+		bad = vmlc_bad_node(hdr, ast, i);
+
+	for (size_t r = 0; !bad && r < hdr->root_ctr; r++)
+		bad = ast->roots[r] >= hdr->node_ctr;
+
+	for (size_t s = 0; !bad && s < hdr->sym_ctr; s++)
+		bad = vmlc_bad_string(hdr, bytes, syms[s].label) || syms[s].sy_type > E_FUNC_TYPE;
+
+	if (!bad) {
+		ast->strs = malloc((hdr->str_ctr + 1) * sizeof(char *));
+		bad = !ast->strs;
+	}
+
+	// Strings are used straight out of the mapping. Labels are interned before any
+	// symbol is added, adding one which is already interned can't fail.
+	for (size_t i = 0; !bad && i < hdr->str_ctr; i++) {
+		unsigned int id = InternPool_add_static(pool, bytes + strs[i].offset, strs[i].length);
+		bad = id == INTERN_ERROR_ID;
+		if (!bad)
+			ast->strs[i] = InternPool_get(pool, id);
+	}
+
+	for (size_t s = 0; !bad && s < hdr->sym_ctr; s++)
+		bad = InternPool_add_static(pool, bytes + syms[s].label.offset, syms[s].label.length) == INTERN_ERROR_ID;
+
+	if (bad) {
+		if (ast)
+			FlatAst_free(ast);
+		munmap(map, map_len);
+		return NULL;
+	}
+
+	ast->str_ctr = ast->str_cap = hdr->str_ctr;
+
+	for (size_t s = 0; s < hdr->sym_ctr; s++) {
+		unsigned int id = InternPool_add_static(pool, bytes + syms[s].label.offset, syms[s].label.length);
+		SyTable_add_symbol(sy_table, InternPool_get(pool, id), NULL, syms[s].lineno, syms[s].sy_type);
+	}
+
+	Vmlc *vmlc = malloc(sizeof(Vmlc));
+	vmlc->map = map;
+	vmlc->map_len = map_len;
+	vmlc->ast = ast;
+	return vmlc;
+}
+
+int Vmlc_save(const char *path, unsigned long long src_hash, size_t src_len,
+				SyTable *sy_table, FlatAst *ast) {
+	if (!path || null_check(sy_table, "vmlc save") || null_check(ast, "vmlc save")) return -1;
+
+	VmlcHeader hdr = { 0 };
+	VmlcString *strs = malloc((ast->str_ctr + 1) * sizeof(VmlcString));
+	VmlcSymbol *syms = malloc((sy_table->sym_ctr + 1) * sizeof(VmlcSymbol));
+	size_t off[VMLC_SECTIONS];
+	size_t str_bytes = 0;
+	int ret = -1;
+	int err = !strs || !syms;
+
+	// Strings of the FlatAst followed by symbol labels.
+	for (size_t i = 0; !err && i < ast->str_ctr; i++) {
+		strs[i].offset = str_bytes;
+		strs[i].length = strlen(ast->strs[i]);
+		str_bytes += strs[i].length + 1;
+	}
+
+	// Only declarations are cached, values are assigned when executing.
+	for (size_t s = 0; !err && s < sy_table->sym_ctr; s++) {
+		Symbol *sy = sy_table->symbols[s];
+		err = sy->val.type != E_NONE_VALUE;
+		syms[s].label.offset = str_bytes;
+		syms[s].label.length = strlen(sy->label);
+		syms[s].lineno = sy->lineno;
+		syms[s].sy_type = sy->sy_type;
+		str_bytes += syms[s].label.length + 1;
+	}
+
+	if (err || str_bytes >= FLAT_NONE || ast->node_ctr >= FLAT_NONE)
+		goto done;
+
+	memcpy(hdr.magic, VMLC_MAGIC, 4);
+	hdr.version = VMLC_VERSION;
+	hdr.src_hash = src_hash;
+	hdr.src_len = src_len;
+	hdr.str_ctr = ast->str_ctr;
+	hdr.node_ctr = ast->node_ctr;
+	hdr.kid_ctr = ast->kid_ctr;
+	hdr.root_ctr = ast->root_ctr;
+	hdr.sym_ctr = sy_table->sym_ctr;
+	hdr.str_bytes = str_bytes;
+	vmlc_layout(&hdr, off);
+
+	// Create cache directory from the path.
+	char tmp[4096];
+	if (snprintf(tmp, sizeof(tmp), "%s", path) >= (int) sizeof(tmp))
+		goto done;
+	char *slash = strrchr(tmp, '/');
+	if (slash && slash != tmp) {
+		*slash = '\0';
+		if (vmlc_mkdirs(tmp))
+			goto done;
+	}
+
+	if (snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long) getpid()) >= (int) sizeof(tmp))
+		goto done;
+
+	FILE *fp = fopen(tmp, "wb");
+	if (!fp)
+		goto done;
+
+	const void *sections[VMLC_SECTIONS - 1] = {
+		strs, ast->types, ast->kwids, ast->values, ast->lhs, ast->rhs, ast->kids, ast->roots, syms
+	};
+	size_t sizes[VMLC_SECTIONS - 1] = {
+		hdr.str_ctr * sizeof(VmlcString), hdr.node_ctr, hdr.node_ctr,
+		hdr.node_ctr * sizeof(unsigned int), hdr.node_ctr * sizeof(FlatIdx), hdr.node_ctr * sizeof(FlatIdx),
+		hdr.kid_ctr * sizeof(FlatIdx), hdr.root_ctr * sizeof(FlatIdx), hdr.sym_ctr * sizeof(VmlcSymbol)
+	};
+
+	err = vmlc_write(fp, &hdr, sizeof(hdr), off[0] - sizeof(hdr));
+	for (int i = 0; !err && i < VMLC_SECTIONS - 1; i++)
+		err = vmlc_write(fp, sections[i], sizes[i], off[i + 1] - off[i] - sizes[i]);
+
+	// String bytes, each null terminated.
+	for (size_t i = 0; !err && i < ast->str_ctr; i++)
+		err = vmlc_write(fp, ast->strs[i], strs[i].length + 1, 0);
+	for (size_t s = 0; !err && s < sy_table->sym_ctr; s++)
+		err = vmlc_write(fp, sy_table->symbols[s]->label, syms[s].label.length + 1, 0);
+
+	if (fclose(fp) || err || rename(tmp, path)) {
+		unlink(tmp);
+		goto done;
+	}
+
+	ret = 0;
+
+done:
+	free(strs);
+	free(syms);
+	return ret;
+}
+
+void Vmlc_free(Vmlc *vmlc) {
+	if (!vmlc) return;
+
+	FlatAst_free(vmlc->ast);
+	munmap(vmlc->map, vmlc->map_len);
+	free(vmlc);
+}
@@ -0,0 +1,25 @@
+# Run a script with vmel and compare what it prints with the expected output.
+#
+# cmake -DVMEL=path -DSCRIPT=path -DEXPECTED=path [-DFLAGS=--tree-walk] [-DTIMEOUT=secs] -P compare.cmake
+
+if(DEFINED TIMEOUT)
+	list(APPEND FLAGS --timeout ${TIMEOUT})
+endif()
+
+execute_process(COMMAND ${VMEL} --no-cache ${FLAGS} ${SCRIPT}
+	OUTPUT_VARIABLE out
+	RESULT_VARIABLE rc)
+
+if(NOT rc EQUAL 0)
+	message(FATAL_ERROR "vmel exited with ${rc}:\n${out}")
+endif()
+
+# Builds without NDEBUG surround the output with banners and dumps.
+string(REGEX REPLACE "^.*\\*\\* Program Output \\*\\*\n-+\n" "" out "${out}")
+string(REGEX REPLACE "-+\n\\*\\* Symbol Table Dump.*$" "" out "${out}")
+
+file(READ ${EXPECTED} expected)
+
+if(NOT out STREQUAL expected)
+	message(FATAL_ERROR "Output of ${SCRIPT} differs from ${EXPECTED}:\n${out}")
+endif()
@@ -0,0 +1,71 @@
+/**
+ * Build time generator for the keyword perfect hash.
+ * 
+ * Searches for a seed under which kw_hash() maps every keyword in keywords.def
+ * to a distinct slot of a table with exactly one slot per keyword, then writes
+ * the seed and slot table as a header consumed by tokens.c.
+ * 
+ * Usage: kwgen <output header>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "tokens.h"
+
+static const struct {
+	const char *id;
+	const char *str;
+} Kwords[] = {
+#define KEYWORD(id, str) { #id, str },
+#include "keywords.def"
+#undef KEYWORD
+};
+
+#define KW_CT (sizeof(Kwords) / sizeof(Kwords[0]))
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "Usage: kwgen <output header>\n");
+		return 1;
+	}
+
+	int slots[KW_CT];
+	unsigned int seed;
+	int found = 0;
+
+	for (seed = 1; seed < 100000000 && !found; seed++) {
+		found = 1;
+		memset(slots, -1, sizeof(slots));
+		for (size_t i = 0; i < KW_CT && found; i++) {
+			unsigned int slot = kw_hash(seed, Kwords[i].str, strlen(Kwords[i].str)) % KW_CT;
+			if (slots[slot] != -1)
+				found = 0;
+			slots[slot] = i;
+		}
+	}
+	seed--;
+
+	if (!found) {
+		fprintf(stderr, "kwgen: no perfect hash seed found\n");
+		return 1;
+	}
+
+	FILE *out = fopen(argv[1], "w");
+	if (!out) {
+		perror("kwgen");
+		return 1;
+	}
+
+	fprintf(out, "/* Generated by tools/kwgen.c from keywords.def, do not edit. */\n\n");
+	fprintf(out, "#ifndef KWHASH_H\n#define KWHASH_H\n\n");
+	fprintf(out, "#define KW_HASH_SEED %uu\n", seed);
+	fprintf(out, "#define KW_HASH_SIZE %zu\n\n", KW_CT);
+	fprintf(out, "static const unsigned char Kw_slots[KW_HASH_SIZE] = {\n");
+	for (size_t i = 0; i < KW_CT; i++) {
+		fprintf(out, "\t%s%s\n", Kwords[slots[i]].id, i + 1 < KW_CT ? "," : "");
+	}
+	fprintf(out, "};\n\n#endif\n");
+
+	fclose(out);
+	return 0;
+}